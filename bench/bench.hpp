@@ -0,0 +1,74 @@
+﻿#ifndef __EXTIOS_BENCH_HPP__
+#define __EXTIOS_BENCH_HPP__
+
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::steady_clock
+#include <cstdint> // std::uint64_t
+#include <cstdio> // std::FILE
+#include <string> // std::string
+
+// 基准测试的命令行参数
+struct bench_options
+{
+	double min_time; // 每项测试最少运行的秒数
+	std::size_t corpus_size; // 每种语料转换成UTF-8后的字节数
+	std::string filter; // 只运行名称或语料包含该字符串的测试, 为空时运行全部测试
+	bool csv; // 以CSV格式输出结果
+	bool list; // 只列出测试名称, 不运行
+};
+
+// 一项测试平均每次重复的耗时和内存分配
+struct measurement
+{
+	double seconds; // 耗时秒数
+	double allocations; // 内存分配次数
+	double allocated_bytes; // 分配的字节数
+};
+
+// 测试结果的输出位置, 测试流对象时标准输出会被重定向
+extern std::FILE *bench_output;
+
+// 替换的全局 operator new 累加的分配次数和字节数
+extern std::atomic<std::uint64_t> allocation_count;
+extern std::atomic<std::uint64_t> allocation_bytes;
+
+// 列出测试名称时输出名称并返回 false
+bool selected(const bench_options &opts, const std::string &name, const std::string &corpus);
+
+// bytes、codepoints 和 calls 是每次重复处理的字节数、码点数和调用被测函数的次数
+void report(const bench_options &opts, const std::string &name, const std::string &corpus, std::uint64_t bytes, std::uint64_t codepoints, std::uint64_t calls, const measurement &m);
+
+void run_codecvt_benches(const bench_options &opts);
+void run_stream_benches(const bench_options &opts);
+
+// 先预热一次, 之后重复调用 func 直到达到最短时间
+template <typename Func>
+measurement measure(const bench_options &opts, Func &&func)
+{
+	func();
+
+	using clock = std::chrono::steady_clock;
+	std::uint64_t iterations = 0;
+	std::uint64_t batch = 1;
+	auto count = allocation_count.load(std::memory_order_relaxed);
+	auto bytes = allocation_bytes.load(std::memory_order_relaxed);
+	auto start = clock::now();
+	double elapsed = 0;
+	while (elapsed < opts.min_time)
+	{
+		for (std::uint64_t i = 0; i < batch; ++i)
+		{
+			func();
+		}
+		iterations += batch;
+		batch *= 2;
+		elapsed = std::chrono::duration<double>(clock::now() - start).count();
+	}
+
+	auto n = static_cast<double>(iterations);
+	return measurement{ elapsed / n,
+		static_cast<double>(allocation_count.load(std::memory_order_relaxed) - count) / n,
+		static_cast<double>(allocation_bytes.load(std::memory_order_relaxed) - bytes) / n };
+}
+
+#endif // !__EXTIOS_BENCH_HPP__
@@ -0,0 +1,445 @@
+﻿#include "bench.hpp"
+#include <extios/extcodecvt.h>
+#include <algorithm> // std::max
+#include <random> // std::mt19937
+#include <type_traits> // std::decay
+#include <string> // std::string std::u32string
+#include <vector> // std::vector
+
+// 防止编译器优化掉被测函数的结果
+static volatile std::size_t sink;
+
+// 一种语料的全部编码, 大块语料只有一段文本, 短字符串语料有多段文本
+struct corpus
+{
+	std::string name; // 语料名称
+	std::uint64_t codepoints; // 全部文本的码点数
+	std::vector<std::string> multibyte;
+	std::vector<std::wstring> widechar;
+	std::vector<std::string> utf8;
+	std::vector<std::u16string> utf16;
+	std::vector<std::u32string> utf32;
+};
+
+
+// 语料中单词的字符种类
+enum class script
+{
+	ascii, // ASCII字母
+	latin, // 带重音符号的拉丁字母
+	cjk, // 中日韩统一表意文字
+	emoji // 表情符号
+};
+
+
+// 生成一个单词, 单词之后附加一个分隔符
+// rng 随机数生成器
+// kind 单词的字符种类
+// text 输出位置
+static void append_word(std::mt19937 &rng, script kind, std::u32string &text)
+{
+	static const char32_t accented[] = U"àâçéèêëîïôùûüÿäöüßñáíóú";
+	auto length = 2 + rng() % 8;
+	for (std::uint32_t i = 0; i < length; ++i)
+	{
+		switch (kind)
+		{
+		case script::ascii:
+			text += static_cast<char32_t>(U'a' + rng() % 26);
+			break;
+		case script::latin:
+			text += rng() % 5 == 0 ? accented[rng() % (sizeof(accented) / sizeof(accented[0]) - 1)] : static_cast<char32_t>(U'a' + rng() % 26);
+			break;
+		case script::cjk:
+			text += static_cast<char32_t>(0x4E00 + rng() % 0x5200);
+			break;
+		case script::emoji:
+			text += static_cast<char32_t>((rng() % 2 == 0 ? 0x1F300 : 0x1F600) + rng() % 0x50);
+			break;
+		}
+	}
+
+	auto r = rng() % 16;
+	if (kind != script::cjk)
+	{
+		text += r == 0 ? U'\n' : r == 1 ? U',' : r == 2 ? U'.' : U' ';
+	}
+	else if (r < 6)
+	{
+		text += r == 0 ? U'\n' : r < 4 ? U'，' : U'。';
+	}
+}
+
+
+// 计算码点编码成UTF-8后的字节数
+// c 码点
+static std::size_t utf8_size(char32_t c)
+{
+	return c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+}
+
+
+// 把码点序列转换成全部编码后加入语料
+// c 语料
+// text 码点序列
+static void add_text(corpus &c, const std::u32string &text)
+{
+	c.codepoints += text.size();
+	c.multibyte.push_back(extios::to_multibyte(text));
+	c.widechar.push_back(extios::to_widechar(text));
+	c.utf8.push_back(extios::to_utf8(text));
+	c.utf16.push_back(extios::to_utf16(text));
+	c.utf32.push_back(text);
+}
+
+
+// 生成全部语料, 混合语料的每个单词随机选择字符种类
+// size 大块语料编码成UTF-8后的字节数
+static std::vector<corpus> make_corpora(std::size_t size)
+{
+	struct kind
+	{
+		const char *name;
+		int scripts; // 1 << script 的组合
+	};
+	static const kind kinds[] =
+	{
+		{ "ascii", 1 << static_cast<int>(script::ascii) },
+		{ "latin", 1 << static_cast<int>(script::latin) },
+		{ "cjk", 1 << static_cast<int>(script::cjk) },
+		{ "emoji", 1 << static_cast<int>(script::ascii) | 1 << static_cast<int>(script::emoji) },
+		{ "mixed", 0xF },
+	};
+
+	std::mt19937 rng(20240501);
+	auto pick = [&](int scripts)
+	{
+		for (;;)
+		{
+			auto s = static_cast<int>(rng() % 4);
+			if (scripts & (1 << s))
+			{
+				return static_cast<script>(s);
+			}
+		}
+	};
+
+	std::vector<corpus> corpora;
+	for (auto &k : kinds)
+	{
+		corpora.emplace_back();
+		corpora.back().name = k.name;
+		corpora.back().codepoints = 0;
+		std::u32string text;
+		std::size_t length = 0;
+		while (length < size)
+		{
+			auto first = text.size();
+			::append_word(rng, pick(k.scripts), text);
+			for (auto i = first; i < text.size(); ++i)
+			{
+				length += ::utf8_size(text[i]);
+			}
+		}
+		::add_text(corpora.back(), text);
+	}
+
+	// 8到64字节的短字符串, 用于测量每次调用的固定开销
+	corpora.emplace_back();
+	corpora.back().name = "short";
+	corpora.back().codepoints = 0;
+	std::size_t total = 0;
+	while (total < size / 16)
+	{
+		std::u32string text;
+		std::u32string word;
+		std::size_t length = 0;
+		auto limit = 8 + rng() % 57;
+		while (length < 8)
+		{
+			word.clear();
+			::append_word(rng, pick(0xF), word);
+			for (auto c : word)
+			{
+				if (length + ::utf8_size(c) > limit)
+				{
+					break;
+				}
+				text += c;
+				length += ::utf8_size(c);
+			}
+		}
+		total += length;
+		::add_text(corpora.back(), text);
+	}
+	return corpora;
+}
+
+
+// 字符集的名称
+// cs 字符集
+static const char * charset_name(extios::charset cs)
+{
+	switch (cs)
+	{
+	case extios::charset::multibyte:
+		return "multibyte";
+	case extios::charset::widechar:
+		return "widechar";
+	case extios::charset::utf8:
+		return "utf8";
+	case extios::charset::utf16:
+		return "utf16";
+	default:
+		return "utf32";
+	}
+}
+
+
+// 语料中对应字符集的文本
+// cs 字符集
+// c 语料
+template <extios::charset cs>
+static const auto & texts_of(const corpus &c)
+{
+	if constexpr (cs == extios::charset::multibyte)
+	{
+		return c.multibyte;
+	}
+	else if constexpr (cs == extios::charset::widechar)
+	{
+		return c.widechar;
+	}
+	else if constexpr (cs == extios::charset::utf8)
+	{
+		return c.utf8;
+	}
+	else if constexpr (cs == extios::charset::utf16)
+	{
+		return c.utf16;
+	}
+	else
+	{
+		return c.utf32;
+	}
+}
+
+
+// 输出字符集对应的 to_* 和 to_*_buffer 函数
+template <extios::charset to>
+struct convert_function;
+
+#define EXTIOS_BENCH_CONVERT_FUNCTION(cs, function)\
+template <>\
+struct convert_function<extios::charset::cs>\
+{\
+	static constexpr const char *name = #function;\
+	template <typename... Args>\
+	static auto string(const Args &...args)\
+	{\
+		return extios::function(args...);\
+	}\
+	template <typename... Args>\
+	static auto buffer(const Args &...args)\
+	{\
+		return extios::function##_buffer(args...);\
+	}\
+}
+
+EXTIOS_BENCH_CONVERT_FUNCTION(multibyte, to_multibyte);
+EXTIOS_BENCH_CONVERT_FUNCTION(widechar, to_widechar);
+EXTIOS_BENCH_CONVERT_FUNCTION(utf8, to_utf8);
+EXTIOS_BENCH_CONVERT_FUNCTION(utf16, to_utf16);
+EXTIOS_BENCH_CONVERT_FUNCTION(utf32, to_utf32);
+
+
+// 对语料的每段文本调用一次 func, 测量并输出结果
+// opts 命令行参数
+// name 测试名称
+// c 语料
+// texts 语料中输入字符集的文本
+// func 被测的函数, 参数是一段文本, 返回转换后的字符数
+template <typename Text, typename Func>
+static void run(const bench_options &opts, const std::string &name, const corpus &c, const std::vector<Text> &texts, Func &&func)
+{
+	if (!::selected(opts, name, c.name))
+	{
+		return;
+	}
+
+	std::uint64_t bytes = 0;
+	for (auto &text : texts)
+	{
+		bytes += text.size() * sizeof(text[0]);
+	}
+	auto m = ::measure(opts, [&]
+	{
+		std::size_t total = 0;
+		for (auto &text : texts)
+		{
+			total += func(text);
+		}
+		::sink = total;
+	});
+	::report(opts, name, c.name, bytes, c.codepoints, texts.size(), m);
+}
+
+
+// 测试一对字符集之间的全部转换函数
+// from 输入的字符集
+// to 输出的字符集
+// opts 命令行参数
+// c 语料
+template <extios::charset from, extios::charset to>
+static void bench_pair(const bench_options &opts, const corpus &c)
+{
+	using function = convert_function<to>;
+	using input_char = typename std::decay<decltype(::texts_of<from>(c)[0][0])>::type;
+	using output_char = typename std::decay<decltype(::texts_of<to>(c)[0][0])>::type;
+	using text_type = std::basic_string<input_char>;
+
+	// 输入是char时没有codecvtor的函数用isutf8区分UTF-8和本地字符集
+	constexpr bool has_flag = sizeof(input_char) == 1 && sizeof(output_char) != 1;
+	constexpr bool unicode = from != extios::charset::multibyte && to != extios::charset::multibyte;
+
+	const auto &texts = ::texts_of<from>(c);
+	extios::codecvtor<from, to> cvtor;
+	auto prefix = std::string("codecvt/") + ::charset_name(from) + ">" + ::charset_name(to) + " ";
+	auto fn = prefix + function::name;
+
+	::run(opts, fn + "(s,n)", c, texts, [&](const text_type &text)
+	{
+		if constexpr (has_flag)
+		{
+			return function::string(text.data(), text.size(), from == extios::charset::utf8).size();
+		}
+		else
+		{
+			return function::string(text.data(), text.size()).size();
+		}
+	});
+	::run(opts, fn + "(cvtor,s,n)", c, texts, [&](const text_type &text)
+	{
+		return function::string(cvtor, text.data(), text.size()).size();
+	});
+	::run(opts, fn + "(text)", c, texts, [&](const text_type &text)
+	{
+		if constexpr (has_flag)
+		{
+			return function::string(text, from == extios::charset::utf8).size();
+		}
+		else
+		{
+			return function::string(text).size();
+		}
+	});
+	::run(opts, fn + "(cvtor,text)", c, texts, [&](const text_type &text)
+	{
+		return function::string(cvtor, text).size();
+	});
+	::run(opts, fn + "_buffer(s,n)", c, texts, [&](const text_type &text)
+	{
+		if constexpr (has_flag)
+		{
+			return function::buffer(text.data(), text.size(), from == extios::charset::utf8).size();
+		}
+		else
+		{
+			return function::buffer(text.data(), text.size()).size();
+		}
+	});
+	::run(opts, fn + "_buffer(cvtor,s,n)", c, texts, [&](const text_type &text)
+	{
+		return function::buffer(cvtor, text.data(), text.size()).size();
+	});
+	::run(opts, fn + "_buffer(text)", c, texts, [&](const text_type &text)
+	{
+		if constexpr (has_flag)
+		{
+			return function::buffer(text, from == extios::charset::utf8).size();
+		}
+		else
+		{
+			return function::buffer(text).size();
+		}
+	});
+	::run(opts, fn + "_buffer(cvtor,text)", c, texts, [&](const text_type &text)
+	{
+		return function::buffer(cvtor, text).size();
+	});
+
+	if constexpr (unicode)
+	{
+		::run(opts, fn + "_buffer(cvtor,s,n,threads)", c, texts, [&](const text_type &text)
+		{
+			return function::buffer(cvtor, text.data(), text.size(), 0u).size();
+		});
+
+		// 输出到预先分配的空间, 每个输入字符最多输出4个字符
+		std::size_t longest = 0;
+		for (auto &text : texts)
+		{
+			longest = std::max(longest, text.size());
+		}
+		std::vector<output_char> dest(longest * 4 + 4);
+		::run(opts, prefix + "convert_into(s,n)", c, texts, [&](const text_type &text)
+		{
+			return extios::convert_into(text.data(), text.size(), dest.data(), dest.size()).written;
+		});
+		::run(opts, prefix + "convert_into(cvtor,s,n)", c, texts, [&](const text_type &text)
+		{
+			return extios::convert_into(cvtor, text.data(), text.size(), dest.data(), dest.size()).written;
+		});
+		::run(opts, prefix + "try_convert_into(s,n)", c, texts, [&](const text_type &text)
+		{
+			return extios::try_convert_into(text.data(), text.size(), dest.data(), dest.size()).written;
+		});
+		::run(opts, prefix + "try_convert_into(cvtor,s,n)", c, texts, [&](const text_type &text)
+		{
+			return extios::try_convert_into(cvtor, text.data(), text.size(), dest.data(), dest.size()).written;
+		});
+	}
+}
+
+
+// 测试从一种字符集到其余字符集的转换函数
+// from 输入的字符集
+// opts 命令行参数
+// c 语料
+template <extios::charset from>
+static void bench_from(const bench_options &opts, const corpus &c)
+{
+	if constexpr (from != extios::charset::multibyte)
+	{
+		::bench_pair<from, extios::charset::multibyte>(opts, c);
+	}
+	if constexpr (from != extios::charset::widechar)
+	{
+		::bench_pair<from, extios::charset::widechar>(opts, c);
+	}
+	if constexpr (from != extios::charset::utf8)
+	{
+		::bench_pair<from, extios::charset::utf8>(opts, c);
+	}
+	if constexpr (from != extios::charset::utf16)
+	{
+		::bench_pair<from, extios::charset::utf16>(opts, c);
+	}
+	if constexpr (from != extios::charset::utf32)
+	{
+		::bench_pair<from, extios::charset::utf32>(opts, c);
+	}
+}
+
+
+void run_codecvt_benches(const bench_options &opts)
+{
+	for (auto &c : ::make_corpora(opts.corpus_size))
+	{
+		::bench_from<extios::charset::multibyte>(opts, c);
+		::bench_from<extios::charset::widechar>(opts, c);
+		::bench_from<extios::charset::utf8>(opts, c);
+		::bench_from<extios::charset::utf16>(opts, c);
+		::bench_from<extios::charset::utf32>(opts, c);
+	}
+}
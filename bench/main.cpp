@@ -0,0 +1,150 @@
+﻿#include "bench.hpp"
+#include <extios/extcodecvt.h>
+#include <cstdio> // std::fprintf std::fputs std::perror
+#include <cstdlib> // std::malloc std::free std::strtod std::strtoull
+#include <cstring> // std::strcmp
+#include <new> // std::bad_alloc
+#ifdef _MSC_VER
+#include <io.h> // _dup
+#else // _MSC_VER
+#include <unistd.h> // dup
+#endif // _MSC_VER
+
+std::FILE *bench_output = stdout;
+
+std::atomic<std::uint64_t> allocation_count(0);
+std::atomic<std::uint64_t> allocation_bytes(0);
+
+// 统计全局的内存分配, 其余形式的 operator new/delete 默认转发到这两个函数
+void * operator new(std::size_t size)
+{
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+	auto p = std::malloc(size != 0 ? size : 1);
+	if (p == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+
+bool selected(const bench_options &opts, const std::string &name, const std::string &corpus)
+{
+	if (!opts.filter.empty() && name.find(opts.filter) == std::string::npos && corpus.find(opts.filter) == std::string::npos)
+	{
+		return false;
+	}
+	if (opts.list)
+	{
+		std::fprintf(bench_output, "%s [%s]\n", name.c_str(), corpus.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+void report(const bench_options &opts, const std::string &name, const std::string &corpus, std::uint64_t bytes, std::uint64_t codepoints, std::uint64_t calls, const measurement &m)
+{
+	double mbps = static_cast<double>(bytes) / m.seconds / 1e6;
+	double mcps = static_cast<double>(codepoints) / m.seconds / 1e6;
+	double ns = m.seconds * 1e9 / static_cast<double>(calls);
+	double allocs = m.allocations / static_cast<double>(calls);
+	double alloc_bytes = m.allocated_bytes / static_cast<double>(calls);
+	if (opts.csv)
+	{
+		std::fprintf(bench_output, "\"%s\",%s,%.2f,%.2f,%.1f,%.2f,%.0f\n", name.c_str(), corpus.c_str(), mbps, mcps, ns, allocs, alloc_bytes);
+	}
+	else
+	{
+		std::fprintf(bench_output, "%-62s %-7s %10.1f %10.1f %12.1f %8.2f %12.0f\n", name.c_str(), corpus.c_str(), mbps, mcps, ns, allocs, alloc_bytes);
+	}
+	std::fflush(bench_output);
+}
+
+
+// 输出使用方法
+static void usage(void)
+{
+	std::fputs(
+		"用法: extios-bench [-t 秒数] [-s 字节数] [-f 过滤] [-l] [--csv]\n"
+		"\n"
+		"  -t 秒数     每项测试最少运行的秒数, 默认是0.1\n"
+		"  -s 字节数   每种语料转换成UTF-8后的字节数, 默认是1048576\n"
+		"  -f 过滤     只运行名称或语料包含该字符串的测试\n"
+		"  -l          只列出测试名称\n"
+		"  --csv       以CSV格式输出结果\n",
+		stderr);
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_options opts{ 0.1, static_cast<std::size_t>(1) << 20, std::string(), false, false };
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--csv") == 0)
+		{
+			opts.csv = true;
+		}
+		else if (std::strcmp(argv[i], "-l") == 0)
+		{
+			opts.list = true;
+		}
+		else if (std::strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			opts.min_time = std::strtod(argv[++i], nullptr);
+		}
+		else if (std::strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+		{
+			opts.corpus_size = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+		{
+			opts.filter = argv[++i];
+		}
+		else
+		{
+			::usage();
+			return 2;
+		}
+	}
+
+#ifdef _MSC_VER
+	bench_output = ::_fdopen(::_dup(1), "w");
+#else // _MSC_VER
+	bench_output = ::fdopen(::dup(1), "w");
+#endif // _MSC_VER
+	if (bench_output == nullptr)
+	{
+		std::perror("extios-bench");
+		return 1;
+	}
+
+	if (!opts.list)
+	{
+		static const char *levels[] = { "scalar", "sse42", "avx2" };
+		std::fprintf(stderr, "implementation: %s\n", levels[static_cast<int>(extios::active_implementation())]);
+		if (opts.csv)
+		{
+			std::fprintf(bench_output, "name,corpus,MB/s,Mcp/s,ns/call,allocs/call,bytes/call\n");
+		}
+		else
+		{
+			std::fprintf(bench_output, "%-62s %-7s %10s %10s %12s %8s %12s\n", "name", "corpus", "MB/s", "Mcp/s", "ns/call", "allocs", "bytes");
+		}
+	}
+	run_codecvt_benches(opts);
+	run_stream_benches(opts);
+	return 0;
+}
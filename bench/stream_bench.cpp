@@ -0,0 +1,263 @@
+﻿#include "bench.hpp"
+#include <extios/extiostream.h>
+#include <extios/iobuf.hpp>
+#include <cstdio> // std::perror
+#include <csignal> // std::signal
+#include <iostream> // std::cout std::cin
+#include <string> // std::string std::u32string
+#include <thread> // std::thread
+#include <fcntl.h> // O_WRONLY
+#ifdef _MSC_VER
+#include <io.h> // _open _dup _dup2 _pipe _write _close
+#define open _open
+#define dup _dup
+#define dup2 _dup2
+#define write _write
+#define close _close
+#else // _MSC_VER
+#include <unistd.h> // dup dup2 pipe write close
+#endif // _MSC_VER
+
+// 每次重复执行的操作数
+static constexpr std::uint64_t operations = 1000;
+
+// 输出的一行文本, 包含ASCII、带重音符号的拉丁字母、汉字和表情符号
+static const char32_t line_text[] = U"2024-05-01 12:00:00 [info] requête traitée 用户登录成功 ✅ id=42";
+
+// 输入的单词, 以空白分隔
+static const char32_t word_text[] = U"alpha bêta 数据 😀 extios stream\n";
+
+// 防止编译器优化掉读入的结果
+static volatile std::size_t sink;
+
+
+// 测量执行operations次操作的函数, 输出结果
+// opts 命令行参数
+// name 测试名称
+// target 输出或输入的位置
+// bytes 每次操作输出或输入的UTF-8字节数
+// codepoints 每次操作输出或输入的码点数
+// func 被测的函数, 执行operations次操作
+template <typename Func>
+static void run(const bench_options &opts, const std::string &name, const char *target, std::uint64_t bytes, std::uint64_t codepoints, Func &&func)
+{
+	if (!::selected(opts, name, target))
+	{
+		return;
+	}
+	auto m = ::measure(opts, func);
+	::report(opts, name, target, bytes * operations, codepoints * operations, operations, m);
+}
+
+
+// 测试一个输出流对象的各种输出操作, 每次重复之后刷新, 不把缓冲的内容留给下一项测试
+// opts 命令行参数
+// name 流对象的名称
+// stream 输出流
+// line 输出的一行文本, 编码与流对象一致
+template <typename Stream, typename Text>
+static void bench_ostream(const bench_options &opts, const std::string &name, Stream &stream, const Text &line)
+{
+	using char_type = typename Text::value_type;
+	const std::u32string text(line_text);
+	const std::uint64_t bytes = extios::to_utf8(text).size();
+	const std::uint64_t codepoints = text.size();
+	const char_type *cstr = line.c_str();
+	const Text newline(1, static_cast<char_type>('\n'));
+	const auto prefix = "stream/" + name;
+
+	::run(opts, prefix + "<<string", "null", bytes, codepoints, [&]
+	{
+		for (std::uint64_t i = 0; i < operations; ++i)
+		{
+			stream << line;
+		}
+		stream.flush();
+	});
+	::run(opts, prefix + "<<cstr", "null", bytes, codepoints, [&]
+	{
+		for (std::uint64_t i = 0; i < operations; ++i)
+		{
+			stream << cstr;
+		}
+		stream.flush();
+	});
+	// 整数都是6位, 浮点数按默认的6位有效数字都输出成7个字符
+	::run(opts, prefix + "<<int", "null", 6, 6, [&]
+	{
+		for (std::uint64_t i = 0; i < operations; ++i)
+		{
+			stream << static_cast<int>(100000 + i);
+		}
+		stream.flush();
+	});
+	::run(opts, prefix + "<<double", "null", 7, 7, [&]
+	{
+		for (std::uint64_t i = 0; i < operations; ++i)
+		{
+			stream << 1000.25 + static_cast<double>(i);
+		}
+		stream.flush();
+	});
+	::run(opts, prefix + ".put", "null", bytes, codepoints, [&]
+	{
+		for (std::uint64_t i = 0; i < operations; ++i)
+		{
+			for (auto ch : line)
+			{
+				stream.put(ch);
+			}
+		}
+		stream.flush();
+	});
+	::run(opts, prefix + "<<string<<'\\n'", "null", bytes + 1, codepoints + 1, [&]
+	{
+		for (std::uint64_t i = 0; i < operations; ++i)
+		{
+			stream << line << newline;
+		}
+		stream.flush();
+	});
+	::run(opts, prefix + "<<string<<std::endl", "null", bytes + 1, codepoints + 1, [&]
+	{
+		for (std::uint64_t i = 0; i < operations; ++i)
+		{
+			stream << line << std::endl;
+		}
+	});
+}
+
+
+// 测试一个输出流对象分别经过 std::cout 和直接写入文件描述符时的输出操作
+// opts 命令行参数
+// name 流对象的名称
+// stream 输出流
+// line 输出的一行文本, 编码与流对象一致
+template <typename charT, typename Text>
+static void bench_ext_ostream(const bench_options &opts, const std::string &name, extios::ext_basic_ostream<charT> &stream, const Text &line)
+{
+	::bench_ostream(opts, name, stream, line);
+
+	auto buffer = static_cast<extios::basic_outputbuf<charT> *>(stream.rdbuf());
+	buffer->attach(1);
+	::bench_ostream(opts, name + "/fd", stream, line);
+	buffer->detach();
+}
+
+
+// 测试一个输入流对象读入单词的操作
+// opts 命令行参数
+// name 流对象的名称
+// stream 输入流
+// word 读入的单词
+template <typename Stream, typename charT>
+static void bench_istream(const bench_options &opts, const std::string &name, Stream &stream, std::basic_string<charT> &word)
+{
+	// 每个单词和之后的一个分隔符
+	const std::u32string text(word_text);
+	const std::uint64_t count = 6;
+	::run(opts, "stream/" + name + ">>string", "pipe", extios::to_utf8(text).size() / count, text.size() / count, [&]
+	{
+		std::size_t total = 0;
+		for (std::uint64_t i = 0; i < operations; ++i)
+		{
+			stream >> word;
+			total += word.size();
+		}
+		::sink = total;
+	});
+	if (!stream)
+	{
+		std::fprintf(stderr, "stream/%s>>string: read failed\n", name.c_str());
+		stream.clear();
+	}
+}
+
+
+// 测试一个输入流对象分别经过 std::cin 和直接读取文件描述符时的输入操作
+// opts 命令行参数
+// name 流对象的名称
+// stream 输入流
+template <typename charT>
+static void bench_ext_istream(const bench_options &opts, const std::string &name, extios::ext_basic_istream<charT> &stream)
+{
+	std::basic_string<charT> word;
+	::bench_istream(opts, name, stream, word);
+
+	auto buffer = static_cast<extios::basic_inputbuf<charT> *>(stream.rdbuf());
+	buffer->attach(0);
+	::bench_istream(opts, name + "/fd", stream, word);
+	buffer->detach();
+}
+
+
+void run_stream_benches(const bench_options &opts)
+{
+	const std::u32string line(line_text);
+
+	// 标准输出重定向到空设备, 测试结束后恢复
+	std::cout.flush();
+#ifdef _MSC_VER
+	int null_fd = ::open("NUL", O_WRONLY);
+#else // _MSC_VER
+	int null_fd = ::open("/dev/null", O_WRONLY);
+#endif // _MSC_VER
+	int stdout_fd = ::dup(1);
+	if (null_fd < 0 || stdout_fd < 0 || ::dup2(null_fd, 1) < 0)
+	{
+		std::perror("extios-bench");
+		return;
+	}
+	::close(null_fd);
+
+	::bench_ostream(opts, "std::cout", std::cout, extios::to_utf8(line));
+	::bench_ext_ostream(opts, "u8cout", extios::u8cout, extios::to_utf8(line));
+	::bench_ext_ostream(opts, "wcout", extios::wcout, extios::to_widechar(line));
+	::bench_ext_ostream(opts, "u16cout", extios::u16cout, extios::to_utf16(line));
+	::bench_ext_ostream(opts, "u32cout", extios::u32cout, line);
+
+	std::cout.flush();
+	::dup2(stdout_fd, 1);
+	::close(stdout_fd);
+
+	// 标准输入重定向到管道, 由另一个线程不断写入单词, 测试结束后关闭管道使写入线程退出
+	int fds[2];
+#ifdef _MSC_VER
+	if (::_pipe(fds, 65536, _O_BINARY) != 0)
+#else // _MSC_VER
+	std::signal(SIGPIPE, SIG_IGN);
+	if (::pipe(fds) != 0)
+#endif // _MSC_VER
+	{
+		std::perror("extios-bench");
+		return;
+	}
+	int stdin_fd = ::dup(0);
+	::dup2(fds[0], 0);
+	::close(fds[0]);
+
+	auto words = extios::to_utf8(std::u32string(word_text));
+	std::string block;
+	while (block.size() < 65536)
+	{
+		block += words;
+	}
+	std::thread writer([&block, fd = fds[1]]
+	{
+		while (::write(fd, block.data(), static_cast<unsigned int>(block.size())) > 0)
+		{
+		}
+		::close(fd);
+	});
+
+	std::string word;
+	::bench_istream(opts, "std::cin", std::cin, word);
+	::bench_ext_istream(opts, "u8cin", extios::u8cin);
+	::bench_ext_istream(opts, "wcin", extios::wcin);
+	::bench_ext_istream(opts, "u16cin", extios::u16cin);
+	::bench_ext_istream(opts, "u32cin", extios::u32cin);
+
+	::dup2(stdin_fd, 0);
+	::close(stdin_fd);
+	writer.join();
+}
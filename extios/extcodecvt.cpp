@@ -1,6 +1,32 @@
 ﻿#include "extcodecvt.h"
-#include <stdexcept> // std::invalid_argument std::length_error
+#include <stdexcept> // std::invalid_argument
+#include <system_error> // std::system_error
 #include <type_traits> // std::is_same
+#include <cstdint> // std::uint64_t
+#include <cstring> // std::memcpy std::memset
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::steady_clock
+#include <thread> // std::thread
+#include <vector> // std::vector
+#include <algorithm> // std::min std::max
+#include <exception> // std::exception_ptr
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define EXTIOS_X86_SIMD
+#include <immintrin.h> // SSE AVX2
+#ifdef _MSC_VER
+#include <intrin.h> // __cpuid __cpuidex _xgetbv
+#else
+#include <cpuid.h> // __get_cpuid __get_cpuid_count
+#endif
+#endif
+
+// GCC和Clang需要为使用扩展指令集的函数单独指定目标指令集, MSVC不需要
+#if defined(__GNUC__)
+#define EXTIOS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define EXTIOS_TARGET(isa)
+#endif
 
 #define throw_if_cvtor_null(cvtor)\
 if (cvtor == nullptr)\
@@ -8,2665 +34,5899 @@ if (cvtor == nullptr)\
 	throw std::invalid_argument("编码转换对象不能是空");\
 }
 
-#define throw_if_string_too_long(length)\
-if ((length) > static_cast<std::size_t>(std::numeric_limits<int>::max()))\
-{\
-	throw std::length_error("需要转换编码的字符串过长");\
-}
+// 抛出输入数据无效的异常
+#define throw_invalid_string()\
+throw std::invalid_argument("需要转换编码的字符串不是有效的字符串")
 
-#ifdef _MSC_VER
 
-#include <numeric> // std::numeric_limits
-#include <Windows.h> // MultiByteToWideChar WideCharToMultiByte
+#ifdef EXTIOS_STATS
 
-#undef max
+// 字符集的种类数, 统计计数按输入和输出字符集索引
+static constexpr std::size_t charset_count = static_cast<std::size_t>(extios::charset::utf32) + 1;
 
-struct extios::codecvtor_base::member_data
+
+// 一种编码转换的统计计数, 各线程并发累加
+struct conversion_counters
 {
+	std::atomic<std::uint64_t> calls;
+	std::atomic<std::uint64_t> input_units;
+	std::atomic<std::uint64_t> output_units;
+	std::atomic<std::uint64_t> malformed;
+	std::atomic<std::uint64_t> allocated_bytes;
+	std::atomic<std::uint64_t> nanoseconds;
 };
 
 
-void * extios::codecvtor_base::handle(void) const noexcept
+// 所有编码转换的统计计数, 静态存储的原子变量初始为0
+static conversion_counters all_counters[::charset_count][::charset_count];
+
+
+// 当前线程正在统计的转换, 嵌套的转换和遇到的无效字符都计入最外层的转换
+static thread_local conversion_counters *active_counters = nullptr;
+
+
+// 字符集的编码单元的字节数
+// cs 字符集
+static std::size_t unit_size(extios::charset cs) noexcept
 {
-	return nullptr;
+	switch (cs)
+	{
+	case extios::charset::widechar:
+		return sizeof(wchar_t);
+	case extios::charset::utf16:
+		return sizeof(char16_t);
+	case extios::charset::utf32:
+		return sizeof(char32_t);
+	default:
+		return sizeof(char);
+	}
 }
 
 
-// UTF-32转UTF-16或者UTF-32转宽字符, 输出对应字符的std::basic_string或者std::vector
-// OnputContainer 容器的返回类型
-// s 需要转换的字符串
-// n 需要转换的字符串的字符数
-template <typename OnputContainer>
-static OnputContainer to_utf16(const char32_t *s, std::size_t n)
+// 统计一次转换, 构造时开始计时, 析构时累加调用次数、输入字符数和耗时, 转换抛出异常时也会计入
+// 输出字符数和分配的字节数由finish从转换结果中获取
+class stats_scope
 {
-	using cahr_type = typename OnputContainer::value_type;
-	constexpr auto iswchar = std::is_same<cahr_type, wchar_t>::value;
-	constexpr auto ischar16 = std::is_same<cahr_type, char16_t>::value;
-	static_assert(iswchar || ischar16, "The output container must be a wide-character or UTF-16 encoding.");
-
-	OnputContainer container;
-	container.reserve(n * 2);
+public:
+	// from 输入的字符集
+	// to 输出的字符集
+	// input 输入的字符数
+	stats_scope(extios::charset from, extios::charset to, std::size_t input) noexcept
+		: m_counters(::active_counters == nullptr ? &::all_counters[static_cast<std::size_t>(from)][static_cast<std::size_t>(to)] : nullptr)
+		, m_to(to)
+		, m_input(input)
+		, m_start()
+	{
+		if (m_counters != nullptr)
+		{
+			::active_counters = m_counters;
+			m_start = std::chrono::steady_clock::now();
+		}
+	}
 
-	for (std::size_t i = 0; i < n; ++i)
+	~stats_scope(void)
 	{
-		auto c = s[i];
-		if (c < 0x10000)
+		if (m_counters != nullptr)
 		{
-			container.push_back(static_cast<cahr_type>(c));
-			continue;
+			auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+			m_counters->calls.fetch_add(1, std::memory_order_relaxed);
+			m_counters->input_units.fetch_add(m_input, std::memory_order_relaxed);
+			m_counters->nanoseconds.fetch_add(static_cast<std::uint64_t>(elapsed.count()), std::memory_order_relaxed);
+			::active_counters = nullptr;
 		}
-		auto t = c - 0x10000;
-		auto h = (((t << 12) >> 22) + 0xD800);
-		auto l = (((t << 22) >> 22) + 0xDC00);
-		container.push_back(static_cast<cahr_type>(h));
-		container.push_back(static_cast<cahr_type>(l));
 	}
 
-	container.shrink_to_fit();
-	return container;
-}
+	stats_scope(const stats_scope &) = delete;
+	stats_scope & operator=(const stats_scope &) = delete;
+
+	// 记录返回的字符串或者std::vector
+	// result 转换结果
+	template <typename OnputContainer>
+	OnputContainer finish(OnputContainer result) noexcept
+	{
+		if (m_counters != nullptr)
+		{
+			m_counters->output_units.fetch_add(result.size(), std::memory_order_relaxed);
+			m_counters->allocated_bytes.fetch_add(result.capacity() * sizeof(typename OnputContainer::value_type), std::memory_order_relaxed);
+		}
+		return result;
+	}
 
+	// 记录输出到调用者提供的空间的转换, 输入字符数按实际转换的长度计算
+	// result 转换结果
+	extios::convert_result finish(extios::convert_result result) noexcept
+	{
+		m_input = result.consumed;
+		add_output(result.written);
+		return result;
+	}
 
-// UTF-8/窄字符转成std::vector<char16_t>或者std::vector<wchar_t>
-// charT char16_t 或者 wchar_t
-// s 需要转换的字符串
-// n 需要转换的字符串的字节数, 不能超过int的最大值
-// CodePage 输入字符串的字符编码
-template <typename charT>
-static std::vector<charT> to_utf16(const char *s, int n, UINT CodePage)
-{
-	if (n <= 0)
+	// 记录输出到调用者提供的空间的转换, 输入字符数按实际转换的长度计算
+	// result 转换结果
+	extios::try_convert_result finish(extios::try_convert_result result) noexcept
 	{
-		return std::vector<charT>();
+		m_input = result.consumed;
+		add_output(result.written);
+		return result;
 	}
 
-	constexpr auto iswchar = std::is_same<charT, wchar_t>::value;
-	constexpr auto ischar16 = std::is_same<charT, char16_t>::value;
-	static_assert(iswchar || ischar16, "The charT must be wchar_t or char16_t.");
+	// 记录文件转换
+	// bytes 写入的字节数
+	void finish_file(std::uint64_t bytes) noexcept
+	{
+		add_output(bytes / ::unit_size(m_to));
+	}
 
-	auto length = ::MultiByteToWideChar(CodePage, 0, s, n, nullptr, 0);
-	if (length == 0)
+private:
+	void add_output(std::uint64_t units) noexcept
 	{
-		throw std::invalid_argument("需要转换编码的字符串不是有效的字符串");
+		if (m_counters != nullptr)
+		{
+			m_counters->output_units.fetch_add(units, std::memory_order_relaxed);
+		}
 	}
 
-	std::vector<charT> buffer(length);
-	wchar_t *pbuffer = reinterpret_cast<wchar_t *>(buffer.data());
-	::MultiByteToWideChar(CodePage, 0, s, n, pbuffer, static_cast<int>(buffer.size()));
-	return buffer;
+	conversion_counters *m_counters; // 计入的计数, 嵌套在其他转换中时是nullptr
+	extios::charset m_to;
+	std::size_t m_input;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+
+// 统计一次转换并返回转换结果, 临时对象在计算转换结果之前构造, 在返回值构造之后析构
+#define record_stats(from, to, n, ...)\
+::stats_scope(from, to, n).finish(__VA_ARGS__)
+
+// 计入一个无效字符
+#define count_malformed()\
+if (::active_counters != nullptr)\
+{\
+	::active_counters->malformed.fetch_add(1, std::memory_order_relaxed);\
 }
 
 
-// UTF-16/宽字符转成std::u32string/std::vector<char32_t>
-// OnputContainer 容器的返回类型
-// InputCharType wchar_t 或 char16_t
-// s 需要转换的字符串
-// n 需要转换的字符串的字符数
-template <typename OnputContainer, typename InputCharType>
-static OnputContainer to_utf32(const InputCharType *s, std::size_t n)
+// 在当前作用域内把无效字符计入指定的统计, 用于其他线程上的转换, 析构时恢复
+class counters_scope
 {
-	constexpr auto iswchar = std::is_same<InputCharType, wchar_t>::value;
-	constexpr auto ischar16 = std::is_same<InputCharType, char16_t>::value;
-	static_assert(iswchar || ischar16, "The input string must be a wide-character or UTF-16 encoding.");
-	static_assert(std::is_same<OnputContainer::value_type, char32_t>::value, "The output container must be an UTF-32 encoding.");
+public:
+	// counters 计入的统计, 为nullptr时不计入
+	explicit counters_scope(conversion_counters *counters) noexcept
+		: m_previous(::active_counters)
+	{
+		::active_counters = counters;
+	}
+
+	~counters_scope(void)
+	{
+		::active_counters = m_previous;
+	}
 
-	OnputContainer container;
-	container.reserve(n);
+	counters_scope(const counters_scope &) = delete;
+	counters_scope & operator=(const counters_scope &) = delete;
 
-	auto iter = s;
-	auto last = s + n;
-	while (iter != last)
+private:
+	conversion_counters *m_previous;
+};
+
+// 当前线程正在统计的转换
+#define current_counters() ::active_counters
+
+// 在当前作用域内把无效字符计入counters
+#define count_into(counters)\
+::counters_scope counters_guard(counters)
+
+#else // EXTIOS_STATS
+
+// 不统计时直接返回转换结果
+#define record_stats(from, to, n, ...)\
+__VA_ARGS__
+
+#define count_malformed()
+
+#define current_counters() nullptr
+
+#define count_into(counters)\
+static_cast<void>(counters)
+
+#endif // EXTIOS_STATS
+
+
+// UTF-8/UTF-16/UTF-32的编解码方式, 按编码单元的字节数区分
+// 宽字符在Windows上是UTF-16, 在Linux上是UTF-32
+template <std::size_t size> struct utf_codec;
+
+
+// UTF-8的编解码方式
+template <> struct utf_codec<1>
+{
+	// 一个字符最多需要的编码单元数
+	static constexpr std::size_t max_units = 4;
+
+	// 解码一个字符
+	// first 指向待解码字符的首个编码单元, 解码成功后指向下一个字符
+	// last 输入字符串的尾后位置
+	// cp 解码得到的码点
+	// 返回值: 输入数据有效返回true, 否则返回false并且不移动first
+	template <typename charT>
+	static bool decode(const charT *&first, const charT *last, char32_t &cp) noexcept
 	{
-		const char16_t prev = *iter;
-		++iter;
-		if (static_cast<std::size_t>(prev - 0xd800) < 2048)
+		auto p = reinterpret_cast<const unsigned char *>(first);
+		auto remain = static_cast<std::size_t>(last - first);
+		char32_t c0 = p[0];
+		if (c0 < 0x80)
+		{
+			cp = c0;
+			++first;
+			return true;
+		}
+
+		std::size_t length;
+		unsigned char lower = 0x80;
+		unsigned char upper = 0xBF;
+		if (c0 < 0xC2)
+		{
+			return false;
+		}
+		else if (c0 < 0xE0)
+		{
+			length = 2;
+			cp = c0 & 0x1F;
+		}
+		else if (c0 < 0xF0)
+		{
+			length = 3;
+			cp = c0 & 0x0F;
+			lower = c0 == 0xE0 ? 0xA0 : 0x80; // 过长编码
+			upper = c0 == 0xED ? 0x9F : 0xBF; // 代理码点
+		}
+		else if (c0 < 0xF5)
+		{
+			length = 4;
+			cp = c0 & 0x07;
+			lower = c0 == 0xF0 ? 0x90 : 0x80; // 过长编码
+			upper = c0 == 0xF4 ? 0x8F : 0xBF; // 超过U+10FFFF
+		}
+		else
+		{
+			return false;
+		}
+
+		if (remain < length || p[1] < lower || p[1] > upper)
+		{
+			return false;
+		}
+		cp = (cp << 6) | (p[1] & 0x3F);
+		for (std::size_t i = 2; i < length; ++i)
 		{
-			if (iter != last)
+			if ((p[i] & 0xC0) != 0x80)
 			{
-				const char16_t curr = *iter;
-				auto is_high_surrogate = (prev & 0xfffffc00) == 0xd800;
-				auto is_low_surrogate = (curr & 0xfffffc00) == 0xdc00;
-				if (is_high_surrogate && is_low_surrogate)
-				{
-					container.push_back((prev << 10) + curr - 0x35fdc00);
-					++iter;
-					continue;
-				}
+				return false;
 			}
-			throw std::invalid_argument("需要转换编码的字符串不是有效的字符串");
+			cp = (cp << 6) | (p[i] & 0x3F);
+		}
+
+		first += length;
+		return true;
+	}
+
+	// 解码一个已经确认有效的字符, 不做任何检查
+	// first 指向待解码字符的首个编码单元, 解码后指向下一个字符
+	// 返回值: 解码得到的码点
+	template <typename charT>
+	static char32_t decode_valid(const charT *&first) noexcept
+	{
+		auto p = reinterpret_cast<const unsigned char *>(first);
+		char32_t c0 = p[0];
+		if (c0 < 0x80)
+		{
+			++first;
+			return c0;
+		}
+		if (c0 < 0xE0)
+		{
+			first += 2;
+			return ((c0 & 0x1F) << 6) | (p[1] & 0x3F);
+		}
+		if (c0 < 0xF0)
+		{
+			first += 3;
+			return ((c0 & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+		}
+		first += 4;
+		return ((c0 & 0x07) << 18) | ((p[1] & 0x3F) << 12) | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+	}
+
+	// 编码一个字符需要的编码单元数
+	// cp 有效的码点
+	static constexpr std::size_t length(char32_t cp) noexcept
+	{
+		return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+	}
+
+	// 编码一个字符
+	// cp 有效的码点
+	// dest 输出位置
+	// 返回值: 输出的尾后位置
+	template <typename charT>
+	static charT * encode(char32_t cp, charT *dest) noexcept
+	{
+		if (cp < 0x80)
+		{
+			*dest++ = static_cast<charT>(cp);
+		}
+		else if (cp < 0x800)
+		{
+			*dest++ = static_cast<charT>(0xC0 | (cp >> 6));
+			*dest++ = static_cast<charT>(0x80 | (cp & 0x3F));
+		}
+		else if (cp < 0x10000)
+		{
+			*dest++ = static_cast<charT>(0xE0 | (cp >> 12));
+			*dest++ = static_cast<charT>(0x80 | ((cp >> 6) & 0x3F));
+			*dest++ = static_cast<charT>(0x80 | (cp & 0x3F));
 		}
 		else
 		{
-			container.push_back(prev);
+			*dest++ = static_cast<charT>(0xF0 | (cp >> 18));
+			*dest++ = static_cast<charT>(0x80 | ((cp >> 12) & 0x3F));
+			*dest++ = static_cast<charT>(0x80 | ((cp >> 6) & 0x3F));
+			*dest++ = static_cast<charT>(0x80 | (cp & 0x3F));
 		}
+		return dest;
 	}
+};
 
-	container.shrink_to_fit();
-	return container;
-}
 
+// UTF-16的编解码方式
+template <> struct utf_codec<2>
+{
+	// 一个字符最多需要的编码单元数
+	static constexpr std::size_t max_units = 2;
 
-// UTF-16/宽字符转换成UTF-8/窄字符的std::vector<char>
-// charT wchar_t 或 char16_t
-// s 需要转换的字符串
-// n 需要转换的字符串的字符数, 不能超过int的最大值
-// CodePage 目标字符编码
-template <typename charT>
-static std::vector<char> to_mbs(const charT *s, int n, UINT CodePage)
+	// 解码一个字符, 参数和返回值同utf_codec<1>::decode
+	template <typename charT>
+	static bool decode(const charT *&first, const charT *last, char32_t &cp) noexcept
+	{
+		char32_t c0 = static_cast<char16_t>(first[0]);
+		if (c0 - 0xD800 >= 0x800)
+		{
+			cp = c0;
+			++first;
+			return true;
+		}
+		if (c0 >= 0xDC00 || last - first < 2)
+		{
+			return false;
+		}
+		char32_t c1 = static_cast<char16_t>(first[1]);
+		if (c1 - 0xDC00 >= 0x400)
+		{
+			return false;
+		}
+		cp = (c0 << 10) + c1 - 0x35FDC00;
+		first += 2;
+		return true;
+	}
+
+	// 编码一个字符需要的编码单元数, 参数和返回值同utf_codec<1>::length
+	static constexpr std::size_t length(char32_t cp) noexcept
+	{
+		return cp < 0x10000 ? 1 : 2;
+	}
+
+	// 编码一个字符, 参数和返回值同utf_codec<1>::encode
+	template <typename charT>
+	static charT * encode(char32_t cp, charT *dest) noexcept
+	{
+		if (cp < 0x10000)
+		{
+			*dest++ = static_cast<charT>(cp);
+		}
+		else
+		{
+			*dest++ = static_cast<charT>(0xD7C0 + (cp >> 10));
+			*dest++ = static_cast<charT>(0xDC00 | (cp & 0x3FF));
+		}
+		return dest;
+	}
+};
+
+
+// UTF-32的编解码方式
+template <> struct utf_codec<4>
 {
-	if (n <= 0)
+	// 一个字符最多需要的编码单元数
+	static constexpr std::size_t max_units = 1;
+
+	// 解码一个字符, 参数和返回值同utf_codec<1>::decode
+	template <typename charT>
+	static bool decode(const charT *&first, const charT *, char32_t &cp) noexcept
 	{
-		return std::vector<char>();
+		char32_t c0 = static_cast<char32_t>(first[0]);
+		if (c0 >= 0x110000 || c0 - 0xD800 < 0x800)
+		{
+			return false;
+		}
+		cp = c0;
+		++first;
+		return true;
 	}
 
-	constexpr auto iswchar = std::is_same<charT, wchar_t>::value;
-	constexpr auto ischar16 = std::is_same<charT, char16_t>::value;
-	static_assert(iswchar || ischar16, "The input container must be a wide-character or UTF-16 string.");
+	// 编码一个字符需要的编码单元数, 参数和返回值同utf_codec<1>::length
+	static constexpr std::size_t length(char32_t) noexcept
+	{
+		return 1;
+	}
 
-	auto wstr = reinterpret_cast<const wchar_t *>(s);
-	auto length = ::WideCharToMultiByte(CodePage, 0, wstr, n, nullptr, 0, nullptr, nullptr);
-	if (length == 0)
+	// 编码一个字符, 参数和返回值同utf_codec<1>::encode
+	template <typename charT>
+	static charT * encode(char32_t cp, charT *dest) noexcept
 	{
-		throw std::invalid_argument("需要转换编码的字符串不是有效的字符串");
+		*dest++ = static_cast<charT>(cp);
+		return dest;
 	}
+};
 
-	std::vector<char> buffer(length);
-	::WideCharToMultiByte(CodePage, 0, wstr, n, buffer.data(), static_cast<int>(buffer.size()), nullptr, nullptr);
 
-	return buffer;
+// 计算Unicode编码转换后的字符数, 只统计编码单元的特征, 不检查输入数据是否有效
+// 循环中没有分支, 开启优化后编译器可以向量化
+// OutputCharType 输出的字符类型
+// InputCharType 输入的字符类型
+// s 需要转换的字符串, 必须是有效的字符串, 否则返回值不准确
+// n 需要转换的字符串的字符数
+template <typename OutputCharType, typename InputCharType>
+static std::size_t utf_length(const InputCharType *s, std::size_t n) noexcept
+{
+	constexpr auto from = sizeof(InputCharType);
+	constexpr auto to = sizeof(OutputCharType);
+	std::size_t length = 0;
+
+	if constexpr (from == to)
+	{
+		length = n;
+	}
+	else if constexpr (from == 1)
+	{
+		// 每个字符有且只有一个非后续字节(不在0x80~0xBF之间), 4字节的字符在UTF-16中需要两个编码单元
+		auto p = reinterpret_cast<const unsigned char *>(s);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			length += static_cast<std::size_t>(static_cast<signed char>(p[i]) > -65);
+			if constexpr (to == 2)
+			{
+				length += static_cast<std::size_t>(p[i] >= 0xF0);
+			}
+		}
+	}
+	else if constexpr (from == 2)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			char32_t c = static_cast<char16_t>(s[i]);
+			if constexpr (to == 1)
+			{
+				// 代理对的每一半各对应2个字节
+				auto is_surrogate = (c & 0xF800) == 0xD800;
+				length += 1 + static_cast<std::size_t>(c >= 0x80) + static_cast<std::size_t>(c >= 0x800 && !is_surrogate);
+			}
+			else
+			{
+				// 代理对只有高代理项对应一个字符
+				length += static_cast<std::size_t>((c & 0xFC00) != 0xDC00);
+			}
+		}
+	}
+	else
+	{
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			auto c = static_cast<char32_t>(s[i]);
+			if constexpr (to == 1)
+			{
+				length += 1 + static_cast<std::size_t>(c >= 0x80) + static_cast<std::size_t>(c >= 0x800) + static_cast<std::size_t>(c >= 0x10000);
+			}
+			else
+			{
+				length += 1 + static_cast<std::size_t>(c >= 0x10000);
+			}
+		}
+	}
+	return length;
 }
 
 
-extios::codecvtor<extios::charset::multibyte, extios::charset::widechar>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+// 检查UTF-8字符串是否有效, 逐个字符解码, 连续8个ASCII字符时整体跳过
+static bool validate_utf8_scalar(const char *s, std::size_t n) noexcept
 {
+	auto first = s;
+	auto last = s + n;
+	while (first != last)
+	{
+		if (last - first >= 8)
+		{
+			std::uint64_t block;
+			std::memcpy(&block, first, sizeof(block));
+			if ((block & 0x8080808080808080ull) == 0)
+			{
+				first += 8;
+				continue;
+			}
+		}
+
+		char32_t cp;
+		if (!utf_codec<1>::decode(first, last, cp))
+		{
+			return false;
+		}
+	}
+	return true;
 }
 
 
-extios::codecvtor<extios::charset::multibyte, extios::charset::utf8>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+#ifdef EXTIOS_X86_SIMD
+
+// 向量化的UTF-8检查使用查表法, 用前一个字节的高4位、低4位和当前字节的高4位分别查表,
+// 三个结果按位与之后不为0说明这两个字节的组合有错误, 每一位表示一种错误
+// 3、4字节字符的第3、4个字节是否是后续字节由前第2、3个字节单独检查
+enum : unsigned char
+{
+	utf8_too_short = 1 << 0, // 前导字节后面不是后续字节
+	utf8_too_long = 1 << 1, // ASCII字符后面是后续字节
+	utf8_overlong_3 = 1 << 2, // 3字节字符的过长编码
+	utf8_too_large = 1 << 3, // 超过U+10FFFF
+	utf8_surrogate = 1 << 4, // 代理码点
+	utf8_overlong_2 = 1 << 5, // 2字节字符的过长编码
+	utf8_too_large_1000 = 1 << 6, // 超过U+10FFFF, 第2个字节是1000____
+	utf8_overlong_4 = 1 << 6, // 4字节字符的过长编码
+	utf8_two_conts = 1 << 7, // 连续两个后续字节
+	utf8_carry = utf8_too_short | utf8_too_long | utf8_two_conts // 只由高4位决定的错误
+};
+
+
+// 前一个字节的高4位对应的错误
+alignas(16) static constexpr unsigned char utf8_byte_1_high[16] =
+{
+	// 0_______ ________
+	utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+	utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+	// 10______ ________
+	utf8_two_conts, utf8_two_conts, utf8_two_conts, utf8_two_conts,
+	// 1100____ ________
+	utf8_too_short | utf8_overlong_2,
+	// 1101____ ________
+	utf8_too_short,
+	// 1110____ ________
+	utf8_too_short | utf8_overlong_3 | utf8_surrogate,
+	// 1111____ ________
+	utf8_too_short | utf8_too_large | utf8_too_large_1000 | utf8_overlong_4
+};
+
+
+// 前一个字节的低4位对应的错误
+alignas(16) static constexpr unsigned char utf8_byte_1_low[16] =
+{
+	// ____0000 ________
+	utf8_carry | utf8_overlong_3 | utf8_overlong_2 | utf8_overlong_4,
+	// ____0001 ________
+	utf8_carry | utf8_overlong_2,
+	// ____001_ ________
+	utf8_carry,
+	utf8_carry,
+	// ____0100 ________
+	utf8_carry | utf8_too_large,
+	// ____0101 ________ 以及更大的值
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	// ____1101 ________
+	utf8_carry | utf8_too_large | utf8_too_large_1000 | utf8_surrogate,
+	utf8_carry | utf8_too_large | utf8_too_large_1000,
+	utf8_carry | utf8_too_large | utf8_too_large_1000
+};
+
+
+// 当前字节的高4位对应的错误
+alignas(16) static constexpr unsigned char utf8_byte_2_high[16] =
+{
+	// ________ 0_______
+	utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+	utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+	// ________ 1000____
+	utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 | utf8_too_large_1000 | utf8_overlong_4,
+	// ________ 1001____
+	utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 | utf8_too_large,
+	// ________ 101_____
+	utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate | utf8_too_large,
+	utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate | utf8_too_large,
+	// ________ 11______
+	utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short
+};
+
+
+// 块末尾的字节超过对应的值说明最后一个字符不完整, 需要下一个块继续检查
+alignas(32) static constexpr unsigned char utf8_incomplete_limit[32] =
+{
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+};
+
+
+// 检查UTF-8字符串是否有效, 每次处理16个字节, 最后不足16个字节时补0处理
+EXTIOS_TARGET("sse4.2")
+static bool validate_utf8_sse42(const char *s, std::size_t n) noexcept
 {
+	const auto byte_1_high = _mm_load_si128(reinterpret_cast<const __m128i *>(utf8_byte_1_high));
+	const auto byte_1_low = _mm_load_si128(reinterpret_cast<const __m128i *>(utf8_byte_1_low));
+	const auto byte_2_high = _mm_load_si128(reinterpret_cast<const __m128i *>(utf8_byte_2_high));
+	const auto incomplete_limit = _mm_load_si128(reinterpret_cast<const __m128i *>(utf8_incomplete_limit + 16));
+	const auto nibble = _mm_set1_epi8(0x0F);
+
+	auto error = _mm_setzero_si128();
+	auto prev_input = _mm_setzero_si128();
+	auto prev_incomplete = _mm_setzero_si128();
+	for (std::size_t i = 0; i < n; i += 16)
+	{
+		__m128i input;
+		if (n - i >= 16)
+		{
+			input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+		}
+		else
+		{
+			alignas(16) char tail[16];
+			std::memset(tail, 0, sizeof(tail));
+			std::memcpy(tail, s + i, n - i);
+			input = _mm_load_si128(reinterpret_cast<const __m128i *>(tail));
+		}
+
+		if (_mm_movemask_epi8(input) == 0)
+		{
+			// 全是ASCII字符时只需要确认前一个块的最后一个字符是完整的
+			error = _mm_or_si128(error, prev_incomplete);
+		}
+		else
+		{
+			auto prev1 = _mm_alignr_epi8(input, prev_input, 15);
+			auto prev2 = _mm_alignr_epi8(input, prev_input, 14);
+			auto prev3 = _mm_alignr_epi8(input, prev_input, 13);
+			auto special = _mm_and_si128(
+				_mm_and_si128(
+					_mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+					_mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+				_mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+
+			// 前第2个字节是3、4字节字符的前导字节或者前第3个字节是4字节字符的前导字节时, 当前字节必须是后续字节
+			auto third = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+			auto fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+			auto must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+			error = _mm_or_si128(error, _mm_xor_si128(must23, special));
+			prev_incomplete = _mm_subs_epu8(input, incomplete_limit);
+		}
+		prev_input = input;
+	}
+	error = _mm_or_si128(error, prev_incomplete);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
 }
 
 
-extios::codecvtor<extios::charset::multibyte, extios::charset::utf16>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+// 检查UTF-8字符串是否有效, 每次处理32个字节, 算法同validate_utf8_sse42
+EXTIOS_TARGET("avx2")
+static bool validate_utf8_avx2(const char *s, std::size_t n) noexcept
 {
+	const auto byte_1_high = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(utf8_byte_1_high)));
+	const auto byte_1_low = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(utf8_byte_1_low)));
+	const auto byte_2_high = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(utf8_byte_2_high)));
+	const auto incomplete_limit = _mm256_load_si256(reinterpret_cast<const __m256i *>(utf8_incomplete_limit));
+	const auto nibble = _mm256_set1_epi8(0x0F);
+
+	auto error = _mm256_setzero_si256();
+	auto prev_input = _mm256_setzero_si256();
+	auto prev_incomplete = _mm256_setzero_si256();
+	for (std::size_t i = 0; i < n; i += 32)
+	{
+		__m256i input;
+		if (n - i >= 32)
+		{
+			input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+		}
+		else
+		{
+			alignas(32) char tail[32];
+			std::memset(tail, 0, sizeof(tail));
+			std::memcpy(tail, s + i, n - i);
+			input = _mm256_load_si256(reinterpret_cast<const __m256i *>(tail));
+		}
+
+		if (_mm256_movemask_epi8(input) == 0)
+		{
+			error = _mm256_or_si256(error, prev_incomplete);
+		}
+		else
+		{
+			// alignr只在128位的通道内移动, 需要先拼出跨通道的前一部分
+			auto shifted = _mm256_permute2x128_si256(prev_input, input, 0x21);
+			auto prev1 = _mm256_alignr_epi8(input, shifted, 15);
+			auto prev2 = _mm256_alignr_epi8(input, shifted, 14);
+			auto prev3 = _mm256_alignr_epi8(input, shifted, 13);
+			auto special = _mm256_and_si256(
+				_mm256_and_si256(
+					_mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+					_mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble))),
+				_mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+			auto third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+			auto fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+			auto must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+			error = _mm256_or_si256(error, _mm256_xor_si256(must23, special));
+			prev_incomplete = _mm256_subs_epu8(input, incomplete_limit);
+		}
+		prev_input = input;
+	}
+	error = _mm256_or_si256(error, prev_incomplete);
+	return _mm256_testz_si256(error, error) != 0;
+}
+
+#endif // EXTIOS_X86_SIMD
+
+
+// 有效的UTF-8转成UTF-16或UTF-32, 逐个字符转换
+// OutputCharType char16_t 或 char32_t
+// s 需要转换的字符串, 必须是有效的UTF-8
+// n 需要转换的字符串的字节数
+// dest 输出位置, 必须能容纳全部输出
+// 返回值: 输出的尾后位置
+template <typename OutputCharType>
+static OutputCharType * utf8_to_utf_scalar(const char *s, std::size_t n, OutputCharType *dest, OutputCharType *) noexcept
+{
+	for (auto last = s + n; s != last; )
+	{
+		dest = utf_codec<sizeof(OutputCharType)>::encode(utf_codec<1>::decode_valid(s), dest);
+	}
+	return dest;
+}
+
+
+#ifdef EXTIOS_X86_SIMD
+
+// UTF-8解码的重排表, 用16字节块内前12个字节中每个字符最后一个字节的位置查表
+// 前6个字符都不超过2字节时一次转换6个字符, 每个字符的字节重排到一个16位的通道
+// 否则前4个字符都不超过3字节时一次转换4个字符, 每个字符的字节重排到一个32位的通道
+// 其他情况(包含4字节的字符)逐个字符转换
+struct utf8_shuffle_tables
+{
+	static constexpr unsigned char none = 0xFF; // 无法向量化
+	static constexpr unsigned char two_byte_count = 64; // 6个字符各1~2字节的重排方式数
+	static constexpr unsigned char three_byte_count = 81; // 4个字符各1~3字节的重排方式数
+
+	unsigned char index[4096][2]; // 重排方式的编号和消耗的字节数
+	unsigned char shuffle[two_byte_count + three_byte_count][16]; // pshufb使用的重排方式, 0x80表示填0
+};
+
+
+// 生成UTF-8解码的重排表
+static constexpr utf8_shuffle_tables make_utf8_shuffle_tables(void)
+{
+	utf8_shuffle_tables tables{};
+
+	// 编号的第j位表示第j个字符是2字节, 最后一个字节放到低8位, 前导字节放到高8位
+	for (unsigned id = 0; id < utf8_shuffle_tables::two_byte_count; ++id)
+	{
+		unsigned pos = 0;
+		for (unsigned j = 0; j < 8; ++j)
+		{
+			auto length = j < 6 ? 1 + ((id >> j) & 1) : 0;
+			tables.shuffle[id][2 * j] = static_cast<unsigned char>(length > 0 ? pos + length - 1 : 0x80);
+			tables.shuffle[id][2 * j + 1] = static_cast<unsigned char>(length == 2 ? pos : 0x80);
+			pos += length;
+		}
+	}
+
+	// 编号的第j个三进制位加1是第j个字符的字节数, 字节按从后到前的顺序放到32位通道的低位
+	for (unsigned id = 0; id < utf8_shuffle_tables::three_byte_count; ++id)
+	{
+		auto &shuffle = tables.shuffle[utf8_shuffle_tables::two_byte_count + id];
+		unsigned pos = 0;
+		for (unsigned j = 0, x = id; j < 4; ++j, x /= 3)
+		{
+			auto length = 1 + x % 3;
+			auto last = pos + length - 1;
+			shuffle[4 * j] = static_cast<unsigned char>(last);
+			shuffle[4 * j + 1] = static_cast<unsigned char>(length >= 2 ? last - 1 : 0x80);
+			shuffle[4 * j + 2] = static_cast<unsigned char>(length == 3 ? last - 2 : 0x80);
+			shuffle[4 * j + 3] = 0x80;
+			pos += length;
+		}
+	}
+
+	for (unsigned mask = 0; mask < 4096; ++mask)
+	{
+		unsigned lengths[12] = {};
+		unsigned ends[12] = {};
+		unsigned count = 0;
+		for (unsigned i = 0, start = 0; i < 12; ++i)
+		{
+			if (mask & (1u << i))
+			{
+				lengths[count] = i + 1 - start;
+				ends[count] = i;
+				++count;
+				start = i + 1;
+			}
+		}
+
+		auto two_bytes = count >= 6;
+		auto three_bytes = count >= 4;
+		unsigned two_id = 0;
+		unsigned three_id = 0;
+		for (unsigned j = 0, weight = 1; j < 6 && j < count; ++j)
+		{
+			two_bytes = two_bytes && lengths[j] <= 2;
+			two_id |= (lengths[j] - 1) << j;
+			if (j < 4)
+			{
+				three_bytes = three_bytes && lengths[j] <= 3;
+				three_id += (lengths[j] - 1) * weight;
+				weight *= 3;
+			}
+		}
+
+		if (two_bytes)
+		{
+			tables.index[mask][0] = static_cast<unsigned char>(two_id);
+			tables.index[mask][1] = static_cast<unsigned char>(ends[5] + 1);
+		}
+		else if (three_bytes)
+		{
+			tables.index[mask][0] = static_cast<unsigned char>(utf8_shuffle_tables::two_byte_count + three_id);
+			tables.index[mask][1] = static_cast<unsigned char>(ends[3] + 1);
+		}
+		else
+		{
+			tables.index[mask][0] = utf8_shuffle_tables::none;
+			tables.index[mask][1] = 0;
+		}
+	}
+	return tables;
+}
+
+
+alignas(16) static constexpr utf8_shuffle_tables utf8_shuffle = ::make_utf8_shuffle_tables();
+
+
+// 转换一个64字节块中的字符, 每次用12个字节的字符结尾位置查表, 直到剩下的字节不足16个
+// 各个字符结尾的位置预先一次算好, 查表不需要等待上一次读取输入
+// 调用者保证输入还有至少64个字节, 输出还有至少64个字符的空间
+// OutputCharType char16_t 或 char32_t
+// s 64字节块的首地址, 必须是字符的开头
+// nonascii 每一位表示对应的字节是否不是ASCII字符
+// ends 每一位表示对应的字节是否是字符的最后一个字节, 只使用前60位
+// dest 输出位置, 转换后指向输出的尾后位置
+// 返回值: 转换的字节数, 停在字符的开头
+template <typename OutputCharType>
+EXTIOS_TARGET("sse4.2")
+static inline std::size_t utf8_decode_block_sse42(const char *s, std::uint64_t nonascii, std::uint64_t ends, OutputCharType *&dest) noexcept
+{
+	constexpr auto isutf32 = sizeof(OutputCharType) == 4;
+	auto pdest = reinterpret_cast<__m128i *>(dest);
+	std::size_t offset = 0;
+	while (offset <= 48)
+	{
+		auto input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + offset));
+		if (((nonascii >> offset) & 0xFFFF) == 0)
+		{
+			// 16个ASCII字符直接扩展
+			auto low = _mm_unpacklo_epi8(input, _mm_setzero_si128());
+			auto high = _mm_unpackhi_epi8(input, _mm_setzero_si128());
+			if constexpr (isutf32)
+			{
+				_mm_storeu_si128(pdest, _mm_unpacklo_epi16(low, _mm_setzero_si128()));
+				_mm_storeu_si128(pdest + 1, _mm_unpackhi_epi16(low, _mm_setzero_si128()));
+				_mm_storeu_si128(pdest + 2, _mm_unpacklo_epi16(high, _mm_setzero_si128()));
+				_mm_storeu_si128(pdest + 3, _mm_unpackhi_epi16(high, _mm_setzero_si128()));
+			}
+			else
+			{
+				_mm_storeu_si128(pdest, low);
+				_mm_storeu_si128(pdest + 1, high);
+			}
+			offset += 16;
+			dest += 16;
+			pdest = reinterpret_cast<__m128i *>(dest);
+			continue;
+		}
+
+		auto mask = static_cast<unsigned>(ends >> offset) & 0xFFF;
+		auto id = utf8_shuffle.index[mask][0];
+		if (id < utf8_shuffle_tables::two_byte_count)
+		{
+			auto shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf8_shuffle.shuffle[id]));
+			auto units = _mm_shuffle_epi8(input, shuffle);
+			auto low = _mm_and_si128(units, _mm_set1_epi16(0x007F));
+			auto high = _mm_and_si128(_mm_srli_epi16(units, 2), _mm_set1_epi16(0x07C0));
+			auto codepoints = _mm_or_si128(low, high);
+			if constexpr (isutf32)
+			{
+				_mm_storeu_si128(pdest, _mm_unpacklo_epi16(codepoints, _mm_setzero_si128()));
+				_mm_storeu_si128(pdest + 1, _mm_unpackhi_epi16(codepoints, _mm_setzero_si128()));
+			}
+			else
+			{
+				_mm_storeu_si128(pdest, codepoints);
+			}
+			dest += 6;
+			offset += utf8_shuffle.index[mask][1];
+		}
+		else if (id != utf8_shuffle_tables::none)
+		{
+			auto shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf8_shuffle.shuffle[id]));
+			auto units = _mm_shuffle_epi8(input, shuffle);
+			auto low = _mm_and_si128(units, _mm_set1_epi32(0x7F));
+			auto middle = _mm_srli_epi32(_mm_and_si128(units, _mm_set1_epi32(0x3F00)), 2);
+			auto high = _mm_srli_epi32(_mm_and_si128(units, _mm_set1_epi32(0x0F0000)), 4);
+			auto codepoints = _mm_or_si128(_mm_or_si128(low, middle), high);
+			if constexpr (isutf32)
+			{
+				_mm_storeu_si128(pdest, codepoints);
+			}
+			else
+			{
+				// 取出每个32位通道的低16位
+				auto pack = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+				_mm_storeu_si128(pdest, _mm_shuffle_epi8(codepoints, pack));
+			}
+			dest += 4;
+			offset += utf8_shuffle.index[mask][1];
+		}
+		else
+		{
+			// 包含4字节的字符, 逐个转换接下来12个字节中的字符, 读取不会超出这16个字节
+			auto p = s + offset;
+			for (auto stop = p + 12; p < stop; )
+			{
+				dest = utf_codec<sizeof(OutputCharType)>::encode(utf_codec<1>::decode_valid(p), dest);
+			}
+			offset = static_cast<std::size_t>(p - s);
+		}
+		pdest = reinterpret_cast<__m128i *>(dest);
+	}
+	return offset;
+}
+
+
+// 有效的UTF-8转成UTF-16或UTF-32, 每次处理64个字节, 参数和返回值同utf8_to_utf_scalar
+template <typename OutputCharType>
+EXTIOS_TARGET("sse4.2")
+static OutputCharType * utf8_to_utf_sse42(const char *s, std::size_t n, OutputCharType *dest, OutputCharType *dest_last) noexcept
+{
+	auto last = s + n;
+	const auto continuation = _mm_set1_epi8(static_cast<char>(0xC0));
+	while (last - s >= 64 && dest_last - dest >= 64)
+	{
+		std::uint64_t nonascii = 0;
+		std::uint64_t starts = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			auto input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 16 * i));
+			nonascii |= static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(input))) << (16 * i);
+			starts |= static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmplt_epi8(input, continuation)))) << (16 * i);
+		}
+		// 后一个字节不是后续字节(0x80~0xBF)的位置是字符的最后一个字节
+		s += ::utf8_decode_block_sse42(s, nonascii, ~starts >> 1, dest);
+	}
+	return ::utf8_to_utf_scalar(s, static_cast<std::size_t>(last - s), dest, dest_last);
+}
+
+
+// 有效的UTF-8转成UTF-16或UTF-32, 64个字节都是ASCII字符时一次扩展, 其他情况同utf8_to_utf_sse42
+template <typename OutputCharType>
+EXTIOS_TARGET("avx2")
+static OutputCharType * utf8_to_utf_avx2(const char *s, std::size_t n, OutputCharType *dest, OutputCharType *dest_last) noexcept
+{
+	auto last = s + n;
+	const auto continuation = _mm256_set1_epi8(static_cast<char>(0xC0));
+	while (last - s >= 64 && dest_last - dest >= 64)
+	{
+		auto input0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s));
+		auto input1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + 32));
+		auto nonascii = static_cast<std::uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(input0)))
+			| static_cast<std::uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(input1))) << 32;
+		if (nonascii == 0)
+		{
+			auto pdest = reinterpret_cast<__m256i *>(dest);
+			if constexpr (sizeof(OutputCharType) == 4)
+			{
+				for (int i = 0; i < 8; ++i)
+				{
+					_mm256_storeu_si256(pdest + i, _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(s + 8 * i))));
+				}
+			}
+			else
+			{
+				_mm256_storeu_si256(pdest, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(input0)));
+				_mm256_storeu_si256(pdest + 1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(input0, 1)));
+				_mm256_storeu_si256(pdest + 2, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(input1)));
+				_mm256_storeu_si256(pdest + 3, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(input1, 1)));
+			}
+			s += 64;
+			dest += 64;
+			continue;
+		}
+
+		auto starts = static_cast<std::uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(continuation, input0))))
+			| static_cast<std::uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(continuation, input1)))) << 32;
+		s += ::utf8_decode_block_sse42(s, nonascii, ~starts >> 1, dest);
+	}
+	return ::utf8_to_utf_sse42(s, static_cast<std::size_t>(last - s), dest, dest_last);
+}
+
+#endif // EXTIOS_X86_SIMD
+
+
+// 编码转换结束的原因
+enum class utf_status
+{
+	ok, // 全部输入都已转换
+	invalid, // 遇到无效的字符
+	exhausted // 输出空间不足以容纳下一个字符
+};
+
+
+// Unicode编码之间的转换, 逐个字符转换, 只转换输出空间足够容纳的完整字符
+// OutputCharType 输出的字符类型
+// InputCharType 输入的字符类型
+// first 需要转换的字符串的首地址, 转换后指向第一个未转换的字符
+// last 需要转换的字符串的尾后位置
+// dest 输出位置, 转换后指向输出的尾后位置
+// dest_last 输出空间的尾后位置
+// 返回值: 转换结束的原因
+template <typename OutputCharType, typename InputCharType>
+static utf_status utf_transcode_scalar(const InputCharType *&first, const InputCharType *last, OutputCharType *&dest, OutputCharType *dest_last) noexcept
+{
+	using input_codec = utf_codec<sizeof(InputCharType)>;
+	using output_codec = utf_codec<sizeof(OutputCharType)>;
+	using input_unit = typename std::make_unsigned<InputCharType>::type;
+
+	auto status = utf_status::ok;
+	auto in = first;
+	auto out = dest;
+	while (in != last)
+	{
+		if (out == dest_last)
+		{
+			status = utf_status::exhausted;
+			break;
+		}
+
+		// ASCII字符在所有Unicode编码中的值都相同
+		auto c = static_cast<input_unit>(*in);
+		if (c < 0x80)
+		{
+			*out++ = static_cast<OutputCharType>(c);
+			++in;
+			continue;
+		}
+
+		char32_t cp;
+		auto next = in;
+		if (!input_codec::decode(next, last, cp))
+		{
+			status = utf_status::invalid;
+			break;
+		}
+		if (static_cast<std::size_t>(dest_last - out) < output_codec::length(cp))
+		{
+			status = utf_status::exhausted;
+			break;
+		}
+		out = output_codec::encode(cp, out);
+		in = next;
+	}
+	first = in;
+	dest = out;
+	return status;
+}
+
+
+#ifdef EXTIOS_X86_SIMD
+
+// UTF-16转UTF-8的压缩表, 每项前16个字节是pshufb的重排方式, 0x80表示填0, 最后一个字节是输出的字节数
+struct utf16_pack_tables
+{
+	// 8个16位通道, 低字节是ASCII字符或者2字节字符的前导字节, 高字节是2字节字符的后续字节
+	// 编号的第j位表示第j个通道是ASCII字符
+	unsigned char two_byte[256][17];
+
+	// 4个32位通道, 从低到高依次是字符的第1~3个字节
+	// 编号的低4位表示对应的通道不少于2字节, 高4位表示不少于3字节
+	unsigned char three_byte[256][17];
+};
+
+
+// 生成UTF-16转UTF-8的压缩表
+static constexpr utf16_pack_tables make_utf16_pack_tables(void)
+{
+	utf16_pack_tables tables{};
+	for (unsigned mask = 0; mask < 256; ++mask)
+	{
+		unsigned length = 0;
+		for (unsigned j = 0; j < 8; ++j)
+		{
+			tables.two_byte[mask][length++] = static_cast<unsigned char>(2 * j);
+			if ((mask & (1u << j)) == 0)
+			{
+				tables.two_byte[mask][length++] = static_cast<unsigned char>(2 * j + 1);
+			}
+		}
+		tables.two_byte[mask][16] = static_cast<unsigned char>(length);
+
+		length = 0;
+		for (unsigned j = 0; j < 4; ++j)
+		{
+			auto bytes = 1 + ((mask >> j) & 1) + ((mask >> (j + 4)) & 1);
+			for (unsigned k = 0; k < bytes; ++k)
+			{
+				tables.three_byte[mask][length++] = static_cast<unsigned char>(4 * j + k);
+			}
+		}
+		for (auto k = length; k < 16; ++k)
+		{
+			tables.three_byte[mask][k] = 0x80;
+		}
+		tables.three_byte[mask][16] = static_cast<unsigned char>(length);
+	}
+	return tables;
+}
+
+
+static constexpr utf16_pack_tables utf16_pack = ::make_utf16_pack_tables();
+
+
+// 4个不是代理项的UTF-16字符(已经扩展到32位通道)转成UTF-8, 调用者保证输出还有至少16个字节的空间
+// units 需要转换的字符
+// dest 输出位置, 转换后指向输出的尾后位置
+EXTIOS_TARGET("sse4.2")
+static inline void utf16_to_utf8_bmp_sse42(__m128i units, char *&dest) noexcept
+{
+	const auto low6 = _mm_set1_epi32(0x3F);
+	const auto continuation = _mm_set1_epi32(0x80);
+	auto last_byte = _mm_or_si128(_mm_and_si128(units, low6), continuation);
+	auto two = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(units, 6), _mm_set1_epi32(0xC0)), _mm_slli_epi32(last_byte, 8));
+	auto three = _mm_or_si128(
+		_mm_or_si128(_mm_srli_epi32(units, 12), _mm_set1_epi32(0xE0)),
+		_mm_or_si128(_mm_slli_epi32(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(units, 6), low6), continuation), 8), _mm_slli_epi32(last_byte, 16)));
+
+	auto ge80 = _mm_cmpgt_epi32(units, _mm_set1_epi32(0x7F));
+	auto ge800 = _mm_cmpgt_epi32(units, _mm_set1_epi32(0x7FF));
+	auto bytes = _mm_or_si128(_mm_andnot_si128(ge80, units), _mm_and_si128(ge80, _mm_or_si128(_mm_andnot_si128(ge800, two), _mm_and_si128(ge800, three))));
+	auto mask = _mm_movemask_ps(_mm_castsi128_ps(ge80)) | (_mm_movemask_ps(_mm_castsi128_ps(ge800)) << 4);
+
+	const auto &entry = utf16_pack.three_byte[mask];
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(dest), _mm_shuffle_epi8(bytes, _mm_loadu_si128(reinterpret_cast<const __m128i *>(entry))));
+	dest += entry[16];
+}
+
+
+// 转换8个UTF-16编码单元, 包含代理项时逐个字符转换, 代理对可能用到第9个编码单元
+// 调用者保证输入还有至少8个编码单元, 输出还有至少32个字节的空间
+// first 需要转换的位置, 转换后指向下一个未转换的字符
+// last 需要转换的字符串的尾后位置
+// input first开始的8个编码单元
+// dest 输出位置, 转换后指向输出的尾后位置
+// 返回值: 输入数据有效返回true, 否则返回false并且first指向无效的字符
+EXTIOS_TARGET("sse4.2")
+static inline bool utf16_to_utf8_block_sse42(const char16_t *&first, const char16_t *last, __m128i input, char *&dest) noexcept
+{
+	if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(input, _mm_set1_epi16(static_cast<short>(0xFF80))), _mm_setzero_si128())) == 0xFFFF)
+	{
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(dest), _mm_packus_epi16(input, input));
+		first += 8;
+		dest += 8;
+		return true;
+	}
+
+	if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(input, _mm_set1_epi16(static_cast<short>(0xF800))), _mm_setzero_si128())) == 0xFFFF)
+	{
+		// 只有1~2字节的字符, 每个字符先生成2个字节, 再去掉ASCII字符多余的字节
+		auto ascii = _mm_cmplt_epi16(input, _mm_set1_epi16(0x80));
+		auto lead = _mm_or_si128(_mm_srli_epi16(input, 6), _mm_set1_epi16(0xC0));
+		auto trail = _mm_slli_epi16(_mm_or_si128(_mm_and_si128(input, _mm_set1_epi16(0x3F)), _mm_set1_epi16(0x80)), 8);
+		auto units = _mm_or_si128(_mm_and_si128(ascii, input), _mm_andnot_si128(ascii, _mm_or_si128(lead, trail)));
+		auto mask = _mm_movemask_epi8(_mm_packs_epi16(ascii, _mm_setzero_si128()));
+
+		const auto &entry = utf16_pack.two_byte[mask];
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dest), _mm_shuffle_epi8(units, _mm_loadu_si128(reinterpret_cast<const __m128i *>(entry))));
+		first += 8;
+		dest += entry[16];
+		return true;
+	}
+
+	auto surrogates = _mm_cmpeq_epi16(_mm_and_si128(input, _mm_set1_epi16(static_cast<short>(0xF800))), _mm_set1_epi16(static_cast<short>(0xD800)));
+	if (_mm_movemask_epi8(surrogates) == 0)
+	{
+		::utf16_to_utf8_bmp_sse42(_mm_unpacklo_epi16(input, _mm_setzero_si128()), dest);
+		::utf16_to_utf8_bmp_sse42(_mm_unpackhi_epi16(input, _mm_setzero_si128()), dest);
+		first += 8;
+		return true;
+	}
+
+	for (auto stop = first + 8; first < stop; )
+	{
+		char32_t cp;
+		if (!utf_codec<2>::decode(first, last, cp))
+		{
+			return false;
+		}
+		dest = utf_codec<1>::encode(cp, dest);
+	}
+	return true;
+}
+
+
+// UTF-16转成UTF-8, 每次处理8~16个编码单元, 剩余部分逐个字符转换, 参数和返回值同utf_transcode_scalar
+EXTIOS_TARGET("sse4.2")
+static utf_status utf16_to_utf8_sse42(const char16_t *&first, const char16_t *last, char *&dest, char *dest_last) noexcept
+{
+	auto in = first;
+	auto out = dest;
+	auto status = utf_status::ok;
+	while (last - in >= 16 && dest_last - out >= 32)
+	{
+		auto input0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+		auto input1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 8));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(input0, input1), _mm_set1_epi16(static_cast<short>(0xFF80))), _mm_setzero_si128())) == 0xFFFF)
+		{
+			// 16个ASCII字符直接压缩成8位
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(input0, input1));
+			in += 16;
+			out += 16;
+			continue;
+		}
+		if (!::utf16_to_utf8_block_sse42(in, last, input0, out))
+		{
+			status = utf_status::invalid;
+			break;
+		}
+	}
+	first = in;
+	dest = out;
+	return status == utf_status::ok ? ::utf_transcode_scalar(first, last, dest, dest_last) : status;
+}
+
+
+// UTF-16转成UTF-8, 连续32个ASCII字符时一次压缩, 其他情况同utf16_to_utf8_sse42
+EXTIOS_TARGET("avx2")
+static utf_status utf16_to_utf8_avx2(const char16_t *&first, const char16_t *last, char *&dest, char *dest_last) noexcept
+{
+	auto in = first;
+	auto out = dest;
+	auto status = utf_status::ok;
+	const auto nonascii = _mm256_set1_epi16(static_cast<short>(0xFF80));
+	while (last - in >= 32 && dest_last - out >= 32)
+	{
+		auto input0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+		auto input1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 16));
+		if (_mm256_testz_si256(_mm256_or_si256(input0, input1), nonascii))
+		{
+			// packus在128位的通道内交错, 需要再按64位重新排列
+			auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(input0, input1), 0xD8);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(out), packed);
+			in += 32;
+			out += 32;
+			continue;
+		}
+		if (!::utf16_to_utf8_block_sse42(in, last, _mm256_castsi256_si128(input0), out))
+		{
+			status = utf_status::invalid;
+			break;
+		}
+	}
+	first = in;
+	dest = out;
+	return status == utf_status::ok ? ::utf16_to_utf8_sse42(first, last, dest, dest_last) : status;
+}
+
+#endif // EXTIOS_X86_SIMD
+
+
+#ifdef EXTIOS_X86_SIMD
+
+// 转换4个UTF-32字符, 包含U+FFFF以上的字符或者无效的字符时逐个字符转换
+// 调用者保证输入还有至少4个字符, 输出还有至少16个字节的空间
+// first 需要转换的位置, 转换后指向下一个未转换的字符
+// input first开始的4个字符
+// dest 输出位置, 转换后指向输出的尾后位置
+// 返回值: 输入数据有效返回true, 否则返回false并且first指向无效的字符
+EXTIOS_TARGET("sse4.2")
+static inline bool utf32_to_utf8_block_sse42(const char32_t *&first, __m128i input, char *&dest) noexcept
+{
+	auto bmp = _mm_cmpeq_epi32(_mm_and_si128(input, _mm_set1_epi32(static_cast<int>(0xFFFF0000))), _mm_setzero_si128());
+	auto surrogates = _mm_cmpeq_epi32(_mm_and_si128(input, _mm_set1_epi32(static_cast<int>(0xFFFFF800))), _mm_set1_epi32(0xD800));
+	if (_mm_movemask_epi8(_mm_andnot_si128(surrogates, bmp)) == 0xFFFF)
+	{
+		::utf16_to_utf8_bmp_sse42(input, dest);
+		first += 4;
+		return true;
+	}
+
+	for (auto stop = first + 4; first < stop; )
+	{
+		char32_t cp;
+		if (!utf_codec<4>::decode(first, stop, cp))
+		{
+			return false;
+		}
+		dest = utf_codec<1>::encode(cp, dest);
+	}
+	return true;
+}
+
+
+// UTF-32转成UTF-8, 每次处理16个字符, 剩余部分逐个字符转换, 参数和返回值同utf_transcode_scalar
+EXTIOS_TARGET("sse4.2")
+static utf_status utf32_to_utf8_sse42(const char32_t *&first, const char32_t *last, char *&dest, char *dest_last) noexcept
+{
+	auto in = first;
+	auto out = dest;
+	auto status = utf_status::ok;
+	const auto nonascii = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+	while (last - in >= 16 && dest_last - out >= 64)
+	{
+		auto pin = reinterpret_cast<const __m128i *>(in);
+		auto input0 = _mm_loadu_si128(pin);
+		auto input1 = _mm_loadu_si128(pin + 1);
+		auto input2 = _mm_loadu_si128(pin + 2);
+		auto input3 = _mm_loadu_si128(pin + 3);
+		auto any = _mm_or_si128(_mm_or_si128(input0, input1), _mm_or_si128(input2, input3));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(any, nonascii), _mm_setzero_si128())) == 0xFFFF)
+		{
+			// 16个ASCII字符直接压缩成8位
+			auto packed = _mm_packus_epi16(_mm_packs_epi32(input0, input1), _mm_packs_epi32(input2, input3));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out), packed);
+			in += 16;
+			out += 16;
+			continue;
+		}
+		if (!(::utf32_to_utf8_block_sse42(in, input0, out)
+			&& ::utf32_to_utf8_block_sse42(in, input1, out)
+			&& ::utf32_to_utf8_block_sse42(in, input2, out)
+			&& ::utf32_to_utf8_block_sse42(in, input3, out)))
+		{
+			status = utf_status::invalid;
+			break;
+		}
+	}
+	first = in;
+	dest = out;
+	return status == utf_status::ok ? ::utf_transcode_scalar(first, last, dest, dest_last) : status;
+}
+
+
+// UTF-32转成UTF-8, 连续32个ASCII字符时一次压缩, 其他情况同utf32_to_utf8_sse42
+EXTIOS_TARGET("avx2")
+static utf_status utf32_to_utf8_avx2(const char32_t *&first, const char32_t *last, char *&dest, char *dest_last) noexcept
+{
+	auto in = first;
+	auto out = dest;
+	auto status = utf_status::ok;
+	const auto nonascii = _mm256_set1_epi32(static_cast<int>(0xFFFFFF80));
+	while (last - in >= 32 && dest_last - out >= 64)
+	{
+		auto pin = reinterpret_cast<const __m256i *>(in);
+		auto input0 = _mm256_loadu_si256(pin);
+		auto input1 = _mm256_loadu_si256(pin + 1);
+		auto input2 = _mm256_loadu_si256(pin + 2);
+		auto input3 = _mm256_loadu_si256(pin + 3);
+		auto any = _mm256_or_si256(_mm256_or_si256(input0, input1), _mm256_or_si256(input2, input3));
+		if (_mm256_testz_si256(any, nonascii))
+		{
+			// pack在128位的通道内交错, 需要再按32位重新排列
+			auto packed = _mm256_packus_epi16(_mm256_packs_epi32(input0, input1), _mm256_packs_epi32(input2, input3));
+			packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(out), packed);
+			in += 32;
+			out += 32;
+			continue;
+		}
+		if (!(::utf32_to_utf8_block_sse42(in, _mm256_castsi256_si128(input0), out)
+			&& ::utf32_to_utf8_block_sse42(in, _mm256_extracti128_si256(input0, 1), out)
+			&& ::utf32_to_utf8_block_sse42(in, _mm256_castsi256_si128(input1), out)
+			&& ::utf32_to_utf8_block_sse42(in, _mm256_extracti128_si256(input1, 1), out)))
+		{
+			status = utf_status::invalid;
+			break;
+		}
+	}
+	first = in;
+	dest = out;
+	return status == utf_status::ok ? ::utf32_to_utf8_sse42(first, last, dest, dest_last) : status;
+}
+
+#endif // EXTIOS_X86_SIMD
+
+
+// 当前CPU支持的扩展指令集
+struct cpu_features
+{
+	bool sse42 = false;
+	bool avx2 = false;
+};
+
+
+// 通过cpuid检测当前CPU支持的扩展指令集, AVX2还需要操作系统支持保存YMM寄存器
+static cpu_features detect_cpu_features(void) noexcept
+{
+	cpu_features features;
+#ifdef EXTIOS_X86_SIMD
+	unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+#ifdef _MSC_VER
+	int regs[4];
+	::__cpuid(regs, 0);
+	auto max_leaf = static_cast<unsigned int>(regs[0]);
+	::__cpuid(regs, 1);
+	ecx = static_cast<unsigned int>(regs[2]);
+#else
+	auto max_leaf = ::__get_cpuid_max(0, nullptr);
+	::__get_cpuid(1, &eax, &ebx, &ecx, &edx);
+#endif
+	// 向量化实现还用到SSSE3和SSE4.1的指令
+	features.sse42 = (ecx & (1u << 9)) != 0 && (ecx & (1u << 19)) != 0 && (ecx & (1u << 20)) != 0;
+
+	auto osxsave = (ecx & (1u << 27)) != 0;
+	auto avx = (ecx & (1u << 28)) != 0;
+	if (!osxsave || !avx || max_leaf < 7)
+	{
+		return features;
+	}
+
+#ifdef _MSC_VER
+	auto xcr0 = static_cast<unsigned int>(::_xgetbv(0));
+	::__cpuidex(regs, 7, 0);
+	ebx = static_cast<unsigned int>(regs[1]);
+#else
+	unsigned int xcr0, xcr0_high;
+	__asm__ __volatile__("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+	::__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx);
+#endif
+	features.avx2 = (xcr0 & 0x6) == 0x6 && (ebx & (1u << 5)) != 0;
+#endif // EXTIOS_X86_SIMD
+	return features;
+}
+
+
+// 一组向量化程度相同的Unicode编码转换实现
+struct utf_kernels
+{
+	extios::implementation level;
+	bool (*validate_utf8)(const char *, std::size_t) noexcept;
+	char16_t * (*utf8_to_utf16)(const char *, std::size_t, char16_t *, char16_t *) noexcept;
+	char32_t * (*utf8_to_utf32)(const char *, std::size_t, char32_t *, char32_t *) noexcept;
+	utf_status (*utf16_to_utf8)(const char16_t *&, const char16_t *, char *&, char *) noexcept;
+	utf_status (*utf32_to_utf8)(const char32_t *&, const char32_t *, char *&, char *) noexcept;
+};
+
+
+static constexpr utf_kernels scalar_kernels =
+{
+	extios::implementation::scalar,
+	&::validate_utf8_scalar,
+	&::utf8_to_utf_scalar<char16_t>,
+	&::utf8_to_utf_scalar<char32_t>,
+	&::utf_transcode_scalar<char, char16_t>,
+	&::utf_transcode_scalar<char, char32_t>
+};
+
+
+#ifdef EXTIOS_X86_SIMD
+
+static constexpr utf_kernels sse42_kernels =
+{
+	extios::implementation::sse42,
+	&::validate_utf8_sse42,
+	&::utf8_to_utf_sse42<char16_t>,
+	&::utf8_to_utf_sse42<char32_t>,
+	&::utf16_to_utf8_sse42,
+	&::utf32_to_utf8_sse42
+};
+
+
+static constexpr utf_kernels avx2_kernels =
+{
+	extios::implementation::avx2,
+	&::validate_utf8_avx2,
+	&::utf8_to_utf_avx2<char16_t>,
+	&::utf8_to_utf_avx2<char32_t>,
+	&::utf16_to_utf8_avx2,
+	&::utf32_to_utf8_avx2
+};
+
+#endif // EXTIOS_X86_SIMD
+
+
+// 查找指定的实现, 当前CPU不支持时返回nullptr
+static const utf_kernels * find_kernels(extios::implementation level) noexcept
+{
+#ifdef EXTIOS_X86_SIMD
+	static const auto features = ::detect_cpu_features();
+	if (level == extios::implementation::avx2 && features.avx2)
+	{
+		return &::avx2_kernels;
+	}
+	if (level == extios::implementation::sse42 && features.sse42)
+	{
+		return &::sse42_kernels;
+	}
+#endif
+	return level == extios::implementation::scalar ? &::scalar_kernels : nullptr;
+}
+
+
+// 当前CPU支持的最快实现
+static const utf_kernels * best_kernels(void) noexcept
+{
+	for (auto level : { extios::implementation::avx2, extios::implementation::sse42 })
+	{
+		if (auto kernels = ::find_kernels(level))
+		{
+			return kernels;
+		}
+	}
+	return &::scalar_kernels;
+}
+
+
+// 正在使用的实现, 静态初始化之前使用标量实现, 加载动态库时切换到当前CPU支持的最快实现
+static std::atomic<const utf_kernels *> active_kernels(&::scalar_kernels);
+static const bool kernels_selected = (::active_kernels.store(::best_kernels()), true);
+
+
+// 检查UTF-8字符串是否有效, 参数和返回值同validate_utf8_scalar
+static bool validate_utf8(const char *s, std::size_t n) noexcept
+{
+	return ::active_kernels.load(std::memory_order_relaxed)->validate_utf8(s, n);
+}
+
+
+// 有效的UTF-8转成UTF-16或UTF-32, 参数和返回值同utf8_to_utf_scalar
+template <typename OutputCharType>
+static OutputCharType * utf8_to_utf(const char *s, std::size_t n, OutputCharType *dest, OutputCharType *dest_last) noexcept
+{
+	auto kernels = ::active_kernels.load(std::memory_order_relaxed);
+	if constexpr (sizeof(OutputCharType) == 2)
+	{
+		return kernels->utf8_to_utf16(s, n, dest, dest_last);
+	}
+	else
+	{
+		return kernels->utf8_to_utf32(s, n, dest, dest_last);
+	}
+}
+
+
+// UTF-16转成UTF-8, 参数和返回值同utf_transcode_scalar
+static utf_status utf16_to_utf8(const char16_t *&first, const char16_t *last, char *&dest, char *dest_last) noexcept
+{
+	return ::active_kernels.load(std::memory_order_relaxed)->utf16_to_utf8(first, last, dest, dest_last);
+}
+
+
+// UTF-32转成UTF-8, 参数和返回值同utf_transcode_scalar
+static utf_status utf32_to_utf8(const char32_t *&first, const char32_t *last, char *&dest, char *dest_last) noexcept
+{
+	return ::active_kernels.load(std::memory_order_relaxed)->utf32_to_utf8(first, last, dest, dest_last);
+}
+
+
+// Unicode编码之间的转换, 有向量化实现时使用向量化实现, 参数和返回值同utf_transcode_scalar
+template <typename OutputCharType, typename InputCharType>
+static utf_status utf_transcode(const InputCharType *&first, const InputCharType *last, OutputCharType *&dest, OutputCharType *dest_last) noexcept
+{
+	if constexpr (sizeof(InputCharType) == 2 && sizeof(OutputCharType) == 1)
+	{
+		// Windows上的wchar_t也是UTF-16
+		auto in = reinterpret_cast<const char16_t *>(first);
+		auto out = reinterpret_cast<char *>(dest);
+		auto status = ::utf16_to_utf8(in, reinterpret_cast<const char16_t *>(last), out, reinterpret_cast<char *>(dest_last));
+		first = reinterpret_cast<const InputCharType *>(in);
+		dest = reinterpret_cast<OutputCharType *>(out);
+		return status;
+	}
+	else if constexpr (sizeof(InputCharType) == 4 && sizeof(OutputCharType) == 1)
+	{
+		// Linux上的wchar_t也是UTF-32
+		auto in = reinterpret_cast<const char32_t *>(first);
+		auto out = reinterpret_cast<char *>(dest);
+		auto status = ::utf32_to_utf8(in, reinterpret_cast<const char32_t *>(last), out, reinterpret_cast<char *>(dest_last));
+		first = reinterpret_cast<const InputCharType *>(in);
+		dest = reinterpret_cast<OutputCharType *>(out);
+		return status;
+	}
+	else if constexpr (sizeof(InputCharType) == 1 && sizeof(OutputCharType) != 1)
+	{
+		// UTF-8按块检查, 有效的块使用向量化实现, 包含无效字符或者输出空间不足的块逐个字符转换
+		// 分块位置避开后续字节, 三个字节内找不到首字节时该后续字节不属于任何有效字符, 也可以分块
+		using unit_type = typename std::conditional<sizeof(OutputCharType) == 2, char16_t, char32_t>::type;
+		constexpr std::size_t block_size = 4096;
+		while (static_cast<std::size_t>(last - first) > block_size)
+		{
+			auto n = block_size;
+			for (std::size_t i = 0; i < 4; ++i)
+			{
+				if ((static_cast<unsigned char>(first[block_size - i]) & 0xC0) != 0x80)
+				{
+					n = block_size - i;
+					break;
+				}
+			}
+
+			if (static_cast<std::size_t>(dest_last - dest) >= n && ::validate_utf8(reinterpret_cast<const char *>(first), n))
+			{
+				auto out = reinterpret_cast<unit_type *>(dest);
+				out = ::utf8_to_utf(reinterpret_cast<const char *>(first), n, out, reinterpret_cast<unit_type *>(dest_last));
+				dest = reinterpret_cast<OutputCharType *>(out);
+				first += n;
+				continue;
+			}
+
+			auto status = ::utf_transcode_scalar(first, first + n, dest, dest_last);
+			if (status != utf_status::ok)
+			{
+				return status;
+			}
+		}
+		return ::utf_transcode_scalar(first, last, dest, dest_last);
+	}
+	else
+	{
+		return ::utf_transcode_scalar(first, last, dest, dest_last);
+	}
+}
+
+
+// 判断字符串是否是一个被截断的字符, 即补充后续的编码单元后可能成为有效的字符
+// charT 字符类型
+// first 字符串的首地址
+// last 字符串的尾后位置
+// 返回值: 被截断时返回true
+template <typename charT>
+static bool utf_truncated(const charT *first, const charT *last) noexcept
+{
+	auto n = static_cast<std::size_t>(last - first);
+	if constexpr (sizeof(charT) == 1)
+	{
+		auto p = reinterpret_cast<const unsigned char *>(first);
+		if (n == 0 || p[0] < 0xC2 || p[0] >= 0xF5)
+		{
+			return false;
+		}
+
+		std::size_t length = p[0] < 0xE0 ? 2 : p[0] < 0xF0 ? 3 : 4;
+		unsigned char lower = p[0] == 0xE0 ? 0xA0 : p[0] == 0xF0 ? 0x90 : 0x80;
+		unsigned char upper = p[0] == 0xED ? 0x9F : p[0] == 0xF4 ? 0x8F : 0xBF;
+		if (n >= length || (n > 1 && (p[1] < lower || p[1] > upper)))
+		{
+			return false;
+		}
+		for (std::size_t i = 2; i < n; ++i)
+		{
+			if ((p[i] & 0xC0) != 0x80)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	else if constexpr (sizeof(charT) == 2)
+	{
+		return n == 1 && static_cast<char32_t>(static_cast<char16_t>(first[0])) - 0xD800 < 0x400;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+
+// 获取无效字符占用的编码单元数
+// UTF-8按照最长的可能有效的前缀计算, 和Unicode标准推荐的U+FFFD替换方式一致
+// charT 字符类型
+// first 无效字符的首地址
+// last 字符串的尾后位置
+// 返回值: 需要替换或丢弃的编码单元数, 至少为1
+template <typename charT>
+static std::size_t utf_invalid_length(const charT *first, const charT *last) noexcept
+{
+	if constexpr (sizeof(charT) == 1)
+	{
+		auto n = static_cast<std::size_t>(last - first);
+		auto p = reinterpret_cast<const unsigned char *>(first);
+		if (p[0] < 0xC2 || p[0] >= 0xF5)
+		{
+			return 1;
+		}
+
+		std::size_t length = p[0] < 0xE0 ? 2 : p[0] < 0xF0 ? 3 : 4;
+		unsigned char lower = p[0] == 0xE0 ? 0xA0 : p[0] == 0xF0 ? 0x90 : 0x80;
+		unsigned char upper = p[0] == 0xED ? 0x9F : p[0] == 0xF4 ? 0x8F : 0xBF;
+		if (n < 2 || p[1] < lower || p[1] > upper)
+		{
+			return 1;
+		}
+
+		std::size_t i = 2;
+		while (i < length && i < n && (p[i] & 0xC0) == 0x80)
+		{
+			++i;
+		}
+		return i;
+	}
+	else
+	{
+		static_cast<void>(last);
+		return 1;
+	}
+}
+
+
+// 按照处理方式进行Unicode编码之间的转换, 替换或丢弃无效的字符后继续使用向量化实现转换后续的字符
+// OutputCharType 输出的字符类型
+// InputCharType 输入的字符类型
+// first 需要转换的字符串的首地址, 转换后指向第一个未转换的字符
+// last 需要转换的字符串的尾后位置
+// dest 输出位置, 转换后指向输出的尾后位置
+// dest_last 输出空间的尾后位置
+// policy 遇到无效字符时的处理方式, throw_exception和stop在无效的字符处停止
+// partial true代表输入数据之后还有后续数据, 末尾不完整的字符不做替换或丢弃, 在该字符处停止
+// error 第一个被替换或丢弃的字符的位置, 调用前需要初始化为nullptr
+// 返回值: 转换结束的原因, 只在没有替换或丢弃无效的字符时返回utf_status::invalid
+template <typename OutputCharType, typename InputCharType>
+static utf_status utf_transcode(const InputCharType *&first, const InputCharType *last, OutputCharType *&dest, OutputCharType *dest_last, extios::error_policy policy, bool partial, const InputCharType *&error) noexcept
+{
+	using output_codec = utf_codec<sizeof(OutputCharType)>;
+
+	for (;;)
+	{
+		auto status = ::utf_transcode(first, last, dest, dest_last);
+		if (status != utf_status::invalid || (partial && ::utf_truncated(first, last)))
+		{
+			return status;
+		}
+		if (policy == extios::error_policy::throw_exception || policy == extios::error_policy::stop)
+		{
+			count_malformed();
+			return status;
+		}
+
+		if (policy != extios::error_policy::skip)
+		{
+			char32_t cp = policy == extios::error_policy::replace ? 0xFFFD : '?';
+			if (static_cast<std::size_t>(dest_last - dest) < output_codec::length(cp))
+			{
+				return utf_status::exhausted;
+			}
+			dest = output_codec::encode(cp, dest);
+		}
+		if (error == nullptr)
+		{
+			error = first;
+		}
+		count_malformed();
+		first += ::utf_invalid_length(first, last);
+	}
+}
+
+
+// Unicode编码之间的转换, 直接输出到对应字符的std::basic_string或者std::vector
+// OnputContainer 容器的返回类型
+// InputCharType 输入的字符类型
+// s 需要转换的字符串
+// n 需要转换的字符串的字符数
+// policy 遇到无效字符时的处理方式
+template <typename OnputContainer, typename InputCharType>
+static OnputContainer utf_convert(const InputCharType *s, std::size_t n, extios::error_policy policy = extios::error_policy::throw_exception)
+{
+	using OutputCharType = typename OnputContainer::value_type;
+
+	if constexpr (sizeof(InputCharType) == 1 && sizeof(OutputCharType) != 1)
+	{
+		// UTF-8先整体检查, 之后逐个字符解码时不再检查
+		if (::validate_utf8(s, n))
+		{
+			OnputContainer buffer(::utf_length<OutputCharType>(s, n), OutputCharType());
+			// wchar_t按照字节数对应到char16_t或者char32_t
+			using unit_type = typename std::conditional<sizeof(OutputCharType) == 2, char16_t, char32_t>::type;
+			auto pbuffer = reinterpret_cast<unit_type *>(buffer.data());
+			::utf8_to_utf(s, n, pbuffer, pbuffer + buffer.size());
+			return buffer;
+		}
+		if (policy == extios::error_policy::throw_exception)
+		{
+			count_malformed();
+			throw_invalid_string();
+		}
+	}
+
+	// 有效的输入数据恰好填满缓冲, 替换无效的字符后输出可能变长, 空间不足时扩大缓冲后继续转换
+	OnputContainer buffer(::utf_length<OutputCharType>(s, n), OutputCharType());
+	std::size_t length = 0;
+	auto first = s;
+	auto last = s + n;
+	const InputCharType *error = nullptr;
+	for (;;)
+	{
+		auto dest = buffer.data() + length;
+		auto status = ::utf_transcode(first, last, dest, buffer.data() + buffer.size(), policy, false, error);
+		length = static_cast<std::size_t>(dest - buffer.data());
+		if (status == utf_status::ok)
+		{
+			break;
+		}
+		if (status == utf_status::invalid)
+		{
+			if (policy == extios::error_policy::throw_exception)
+			{
+				throw_invalid_string();
+			}
+			break;
+		}
+		buffer.resize(buffer.size() + buffer.size() / 2 + utf_codec<sizeof(OutputCharType)>::max_units);
+	}
+	buffer.resize(length);
+	return buffer;
+}
+
+
+// Unicode编码之间的转换, 输出到调用者提供的空间, 不抛出异常
+// OutputCharType 输出的字符类型
+// InputCharType 输入的字符类型
+// s 需要转换的字符串
+// n 需要转换的字符串的字符数
+// dest 输出位置
+// capacity 输出空间能容纳的字符数
+// policy 遇到无效字符时的处理方式
+// partial true代表输入数据之后还有后续数据, 末尾不完整的字符返回convert_status::incomplete_input
+template <typename OutputCharType, typename InputCharType>
+static extios::try_convert_result utf_try_convert_into(const InputCharType *s, std::size_t n, OutputCharType *dest, std::size_t capacity, extios::error_policy policy = extios::error_policy::throw_exception, bool partial = true) noexcept
+{
+	if constexpr (sizeof(InputCharType) == 1 && sizeof(OutputCharType) != 1)
+	{
+		// UTF-8转换后的字符数不超过字节数, 空间足够且输入有效时整体使用向量化实现
+		if (n <= capacity && ::validate_utf8(s, n))
+		{
+			using unit_type = typename std::conditional<sizeof(OutputCharType) == 2, char16_t, char32_t>::type;
+			auto pdest = reinterpret_cast<unit_type *>(dest);
+			auto last = ::utf8_to_utf(s, n, pdest, pdest + capacity);
+			return extios::try_convert_result{ extios::convert_status::ok, n, static_cast<std::size_t>(last - pdest), extios::try_convert_result::no_error };
+		}
+	}
+
+	auto first = s;
+	auto out = dest;
+	const InputCharType *error = nullptr;
+	auto status = ::utf_transcode(first, s + n, out, dest + capacity, policy, partial, error);
+	extios::try_convert_result result{ extios::convert_status::ok, static_cast<std::size_t>(first - s), static_cast<std::size_t>(out - dest), extios::try_convert_result::no_error };
+	if (error != nullptr)
+	{
+		result.error_position = static_cast<std::size_t>(error - s);
+	}
+	if (status == utf_status::exhausted)
+	{
+		result.status = extios::convert_status::insufficient_output;
+	}
+	else if (status == utf_status::invalid)
+	{
+		result.status = ::utf_truncated(first, s + n) ? extios::convert_status::incomplete_input : extios::convert_status::invalid_input;
+		if (error == nullptr)
+		{
+			result.error_position = result.consumed;
+		}
+	}
+	return result;
+}
+
+
+// Unicode编码之间的转换, 输出到调用者提供的空间
+// OutputCharType 输出的字符类型
+// InputCharType 输入的字符类型
+// s 需要转换的字符串
+// n 需要转换的字符串的字符数
+// dest 输出位置
+// capacity 输出空间能容纳的字符数
+// policy 遇到无效字符时的处理方式
+template <typename OutputCharType, typename InputCharType>
+static extios::convert_result utf_convert_into(const InputCharType *s, std::size_t n, OutputCharType *dest, std::size_t capacity, extios::error_policy policy = extios::error_policy::throw_exception)
+{
+	auto result = ::utf_try_convert_into(s, n, dest, capacity, policy, false);
+	if (policy == extios::error_policy::throw_exception && result.error_position != extios::try_convert_result::no_error)
+	{
+		throw_invalid_string();
+	}
+	return extios::convert_result{ result.consumed, result.written };
+}
+
+
+
+// 多线程转换时每段输入数据最少的字节数, 段太小时创建线程的开销超过转换本身
+static constexpr std::size_t min_segment_bytes = static_cast<std::size_t>(1) << 20;
+
+
+// 把分段位置调整到字符边界, 保证分段转换和整体转换的结果相同
+// charT 字符类型
+// s 字符串的首地址
+// pos 分段位置, 大于0且小于字符串长度
+// 返回值: 调整后的分段位置
+template <typename charT>
+static std::size_t utf_boundary(const charT *s, std::size_t pos) noexcept
+{
+	if constexpr (sizeof(charT) == 1)
+	{
+		// 三个字节内找不到首字节时该后续字节不属于任何有效字符, 也可以分段
+		auto p = reinterpret_cast<const unsigned char *>(s);
+		for (std::size_t i = 0; i < 4 && i < pos; ++i)
+		{
+			if ((p[pos - i] & 0xC0) != 0x80)
+			{
+				return pos - i;
+			}
+		}
+		return pos;
+	}
+	else if constexpr (sizeof(charT) == 2)
+	{
+		// 不拆开代理对
+		auto curr = static_cast<char16_t>(s[pos]);
+		auto prev = static_cast<char16_t>(s[pos - 1]);
+		return (curr & 0xFC00) == 0xDC00 && (prev & 0xFC00) == 0xD800 ? pos - 1 : pos;
+	}
+	else
+	{
+		return pos;
+	}
+}
+
+
+// 在count个线程上分别执行task(0)到task(count - 1), 当前线程执行task(0)
+// task 不抛出异常的任务
+// count 线程数
+template <typename Task>
+static void run_parallel(std::size_t count, const Task &task)
+{
+	std::vector<std::thread> workers;
+	workers.reserve(count - 1);
+	try
+	{
+		for (std::size_t i = 1; i < count; ++i)
+		{
+			workers.emplace_back(task, i);
+		}
+	}
+	catch (...)
+	{
+		for (auto &worker : workers)
+		{
+			worker.join();
+		}
+		throw;
+	}
+
+	task(0);
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+}
+
+
+// Unicode编码之间的多线程转换, 直接输出到对应字符的std::basic_string或者std::vector
+// 输入数据在字符边界处分段, 各段先计算输出长度, 按前缀和确定各段的输出位置后同时转换到同一个缓冲
+// 处理方式不是throw_exception时只按处理方式重新转换包含无效字符的段, 再和其他段拼接
+// OnputContainer 容器的返回类型
+// InputCharType 输入的字符类型
+// s 需要转换的字符串
+// n 需要转换的字符串的字符数
+// policy 遇到无效字符时的处理方式
+// threads 最多使用的线程数, 为0时使用硬件支持的并发线程数
+template <typename OnputContainer, typename InputCharType>
+static OnputContainer utf_convert_parallel(const InputCharType *s, std::size_t n, extios::error_policy policy, unsigned int threads)
+{
+	using OutputCharType = typename OnputContainer::value_type;
+
+	if constexpr (sizeof(InputCharType) == sizeof(OutputCharType))
+	{
+		// 相同的编码直接复制, 和单线程的转换函数一致
+		static_cast<void>(policy);
+		static_cast<void>(threads);
+		return OnputContainer(s, s + n);
+	}
+	else
+	{
+		if (threads == 0)
+		{
+			threads = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		auto count = std::min<std::size_t>(threads, n / (::min_segment_bytes / sizeof(InputCharType)));
+		if (count <= 1)
+		{
+			return ::utf_convert<OnputContainer>(s, n, policy);
+		}
+
+		std::vector<std::size_t> bounds(count + 1);
+		bounds[count] = n;
+		for (std::size_t i = 1; i < count; ++i)
+		{
+			bounds[i] = ::utf_boundary(s, n / count * i);
+		}
+
+		std::vector<std::size_t> offsets(count + 1);
+		::run_parallel(count, [&](std::size_t i) noexcept
+		{
+			offsets[i + 1] = ::utf_length<OutputCharType>(s + bounds[i], bounds[i + 1] - bounds[i]);
+		});
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			offsets[i + 1] += offsets[i];
+		}
+
+		// 有效的输入数据恰好填满各段的输出空间
+		OnputContainer buffer(offsets[count], OutputCharType());
+		std::vector<unsigned char> failed(count);
+		::run_parallel(count, [&](std::size_t i) noexcept
+		{
+			// 这里只检查各段是否有效, 无效字符在之后计入
+			count_into(nullptr);
+			auto capacity = offsets[i + 1] - offsets[i];
+			auto result = ::utf_try_convert_into(s + bounds[i], bounds[i + 1] - bounds[i], buffer.data() + offsets[i], capacity, extios::error_policy::throw_exception, false);
+			failed[i] = result.status != extios::convert_status::ok || result.written != capacity;
+		});
+
+		if (std::find(failed.begin(), failed.end(), 1) == failed.end())
+		{
+			return buffer;
+		}
+		if (policy == extios::error_policy::throw_exception)
+		{
+			count_malformed();
+			throw_invalid_string();
+		}
+
+		// 处理方式是stop时在第一个无效的字符处停止, 之后的段都丢弃
+		auto end = count;
+		if (policy == extios::error_policy::stop)
+		{
+			end = static_cast<std::size_t>(std::find(failed.begin(), failed.end(), 1) - failed.begin()) + 1;
+		}
+
+		// 替换或丢弃无效的字符后输出长度会改变, 包含无效字符的段各自转换到单独的缓冲
+		std::vector<OnputContainer> fixed(end);
+		std::vector<std::exception_ptr> errors(end);
+		auto counters = current_counters();
+		::run_parallel(end, [&](std::size_t i) noexcept
+		{
+			if (failed[i])
+			{
+				count_into(counters);
+				try
+				{
+					fixed[i] = ::utf_convert<OnputContainer>(s + bounds[i], bounds[i + 1] - bounds[i], policy);
+				}
+				catch (...)
+				{
+					errors[i] = std::current_exception();
+				}
+			}
+		});
+		for (auto &error : errors)
+		{
+			if (error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+
+		std::size_t length = 0;
+		for (std::size_t i = 0; i < end; ++i)
+		{
+			length += failed[i] ? fixed[i].size() : offsets[i + 1] - offsets[i];
+		}
+		OnputContainer result;
+		result.reserve(length);
+		for (std::size_t i = 0; i < end; ++i)
+		{
+			if (failed[i])
+			{
+				result.insert(result.end(), fixed[i].begin(), fixed[i].end());
+			}
+			else
+			{
+				result.insert(result.end(), buffer.begin() + offsets[i], buffer.begin() + offsets[i + 1]);
+			}
+		}
+		return result;
+	}
+}
+
+// 转换文件时输出缓冲能容纳的字符数, 每填满一次写出一次
+static constexpr std::size_t file_buffer_size = static_cast<std::size_t>(1) << 20;
+
+// 输入文件不能映射到内存时每次读取的字节数
+static constexpr std::size_t file_read_size = static_cast<std::size_t>(1) << 16;
+
+#ifdef _MSC_VER
+
+#include <algorithm> // std::min
+#include <Windows.h> // MultiByteToWideChar WideCharToMultiByte GetCPInfo IsDBCSLeadByteEx CreateFileA MapViewOfFile
+
+#undef min
+#undef max
+
+struct extios::codecvtor_base::member_data
+{
+};
+
+
+void * extios::codecvtor_base::handle(void) const noexcept
+{
+	return nullptr;
+}
+
+
+// UTF-32转UTF-16或者UTF-32转宽字符, 输出对应字符的std::basic_string或者std::vector
+// OnputContainer 容器的返回类型
+// s 需要转换的字符串
+// n 需要转换的字符串的字符数
+// policy 遇到无效字符时的处理方式
+template <typename OnputContainer>
+static OnputContainer to_utf16(const char32_t *s, std::size_t n, extios::error_policy policy = extios::error_policy::throw_exception)
+{
+	using cahr_type = typename OnputContainer::value_type;
+	constexpr auto iswchar = std::is_same<cahr_type, wchar_t>::value;
+	constexpr auto ischar16 = std::is_same<cahr_type, char16_t>::value;
+	static_assert(iswchar || ischar16, "The output container must be a wide-character or UTF-16 encoding.");
+
+	return ::utf_convert<OnputContainer>(s, n, policy);
+}
+
+
+// 系统编码转换函数一次转换的最大字符数, 转换前后的长度都不会超过int的最大值
+static constexpr std::size_t max_chunk_size = static_cast<std::size_t>(1) << 28;
+
+
+// 计算窄字符串一次转换的字节数, 超长的字符串在字符边界处分段
+// s 需要转换的字符串
+// n 需要转换的字符串的字节数
+// CodePage 字符串的字符编码
+// 返回值: 不超过max_chunk_size的字节数
+static std::size_t mbs_chunk_size(const char *s, std::size_t n, UINT CodePage)
+{
+	if (n <= ::max_chunk_size)
+	{
+		return n;
+	}
+
+	CPINFO info;
+	if (!::GetCPInfo(CodePage, &info) || info.MaxCharSize == 1)
+	{
+		return ::max_chunk_size;
+	}
+
+	if (info.MaxCharSize > 2)
+	{
+		// 本地字符集是UTF-8时跳过后续字节
+		auto count = ::max_chunk_size;
+		while (count > ::max_chunk_size - 3 && (static_cast<unsigned char>(s[count]) & 0xC0) == 0x80)
+		{
+			--count;
+		}
+		return count;
+	}
+
+	// 双字节字符集的尾字节可能和首字节相同, 只能从头逐个字符前进
+	std::size_t count = 0;
+	while (count < ::max_chunk_size)
+	{
+		count += ::IsDBCSLeadByteEx(CodePage, static_cast<BYTE>(s[count])) ? 2 : 1;
+	}
+	return count > ::max_chunk_size ? count - 2 : count;
+}
+
+
+// UTF-8/窄字符转成char16_t或者wchar_t的std::basic_string或者std::vector
+// OnputContainer 容器的返回类型
+// s 需要转换的字符串
+// n 需要转换的字符串的字节数, 超过max_chunk_size时分段转换
+// CodePage 输入字符串的字符编码
+// policy 遇到无效字符时的处理方式, 只对UTF-8有效, 本地字符集的无效字符由系统替换
+template <typename OnputContainer>
+static OnputContainer to_utf16(const char *s, std::size_t n, UINT CodePage, extios::error_policy policy = extios::error_policy::throw_exception)
+{
+	using charT = typename OnputContainer::value_type;
+	if (n == 0)
+	{
+		return OnputContainer();
+	}
+
+	constexpr auto iswchar = std::is_same<charT, wchar_t>::value;
+	constexpr auto ischar16 = std::is_same<charT, char16_t>::value;
+	static_assert(iswchar || ischar16, "The charT must be wchar_t or char16_t.");
+
+	// UTF-8使用向量化的Unicode转换, 同时避免MultiByteToWideChar把无效的UTF-8替换成U+FFFD
+	if (CodePage == CP_UTF8)
+	{
+		return ::utf_convert<OnputContainer>(s, n, policy);
+	}
+
+	OnputContainer buffer;
+	std::size_t offset = 0;
+	while (offset < n)
+	{
+		auto count = static_cast<int>(::mbs_chunk_size(s + offset, n - offset, CodePage));
+		auto length = ::MultiByteToWideChar(CodePage, 0, s + offset, count, nullptr, 0);
+		if (length == 0)
+		{
+			count_malformed();
+			throw std::invalid_argument("需要转换编码的字符串不是有效的字符串");
+		}
+
+		auto size = buffer.size();
+		buffer.resize(size + length, charT());
+		wchar_t *pbuffer = reinterpret_cast<wchar_t *>(buffer.data() + size);
+		::MultiByteToWideChar(CodePage, 0, s + offset, count, pbuffer, length);
+		offset += count;
+	}
+	return buffer;
+}
+
+
+// UTF-16/宽字符转成std::u32string/std::vector<char32_t>
+// OnputContainer 容器的返回类型
+// InputCharType wchar_t 或 char16_t
+// s 需要转换的字符串
+// n 需要转换的字符串的字符数
+// policy 遇到无效字符时的处理方式
+template <typename OnputContainer, typename InputCharType>
+static OnputContainer to_utf32(const InputCharType *s, std::size_t n, extios::error_policy policy = extios::error_policy::throw_exception)
+{
+	constexpr auto iswchar = std::is_same<InputCharType, wchar_t>::value;
+	constexpr auto ischar16 = std::is_same<InputCharType, char16_t>::value;
+	static_assert(iswchar || ischar16, "The input string must be a wide-character or UTF-16 encoding.");
+	static_assert(std::is_same<OnputContainer::value_type, char32_t>::value, "The output container must be an UTF-32 encoding.");
+
+	return ::utf_convert<OnputContainer>(s, n, policy);
+}
+
+
+// UTF-16/宽字符转换成UTF-8/窄字符的std::string或者std::vector<char>
+// OnputContainer 容器的返回类型
+// charT wchar_t 或 char16_t
+// s 需要转换的字符串
+// n 需要转换的字符串的字符数, 超过max_chunk_size时分段转换
+// CodePage 目标字符编码
+// policy 遇到无效字符时的处理方式, 只对UTF-8有效, 转换成本地字符集时无效字符由系统替换
+template <typename OnputContainer, typename charT>
+static OnputContainer to_mbs(const charT *s, std::size_t n, UINT CodePage, extios::error_policy policy = extios::error_policy::throw_exception)
+{
+	if (n == 0)
+	{
+		return OnputContainer();
+	}
+
+	constexpr auto iswchar = std::is_same<charT, wchar_t>::value;
+	constexpr auto ischar16 = std::is_same<charT, char16_t>::value;
+	static_assert(iswchar || ischar16, "The input container must be a wide-character or UTF-16 string.");
+
+	// UTF-8使用向量化的Unicode转换, 同时避免WideCharToMultiByte把无效的UTF-16替换成U+FFFD
+	if (CodePage == CP_UTF8)
+	{
+		return ::utf_convert<OnputContainer>(s, n, policy);
+	}
+
+	OnputContainer buffer;
+	auto wstr = reinterpret_cast<const wchar_t *>(s);
+	std::size_t offset = 0;
+	while (offset < n)
+	{
+		// 分段时不拆开代理对
+		auto count = std::min(n - offset, ::max_chunk_size);
+		if (count < n - offset && static_cast<std::size_t>(wstr[offset + count - 1] - 0xD800) < 0x400)
+		{
+			--count;
+		}
+
+		auto length = ::WideCharToMultiByte(CodePage, 0, wstr + offset, static_cast<int>(count), nullptr, 0, nullptr, nullptr);
+		if (length == 0)
+		{
+			count_malformed();
+			throw std::invalid_argument("需要转换编码的字符串不是有效的字符串");
+		}
+
+		auto size = buffer.size();
+		buffer.resize(size + length, char());
+		::WideCharToMultiByte(CodePage, 0, wstr + offset, static_cast<int>(count), buffer.data() + size, length, nullptr, nullptr);
+		offset += count;
+	}
+	return buffer;
+}
+
+
+extios::codecvtor<extios::charset::multibyte, extios::charset::widechar>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::multibyte, extios::charset::utf8>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::multibyte, extios::charset::utf16>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::multibyte, extios::charset::utf32>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::widechar, extios::charset::multibyte>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::widechar, extios::charset::utf8>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::widechar, extios::charset::utf16>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::widechar, extios::charset::utf32>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::utf8, extios::charset::multibyte>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::utf8, extios::charset::widechar>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::utf8, extios::charset::utf16>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::utf8, extios::charset::utf32>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::utf16, extios::charset::multibyte>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::utf16, extios::charset::widechar>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::utf16, extios::charset::utf8>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::utf16, extios::charset::utf32>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::utf32, extios::charset::multibyte>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::utf32, extios::charset::widechar>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::utf32, extios::charset::utf8>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+extios::codecvtor<extios::charset::utf32, extios::charset::utf16>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(), policy)
+{
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const char *s, std::size_t n)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, CP_UTF8);
+	return record_stats(charset::utf8, charset::multibyte, n, ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const char *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, CP_UTF8, cvtor.policy());
+	return record_stats(charset::utf8, charset::multibyte, n, ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const std::string &text)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_UTF8);
+	return record_stats(charset::utf8, charset::multibyte, text.size(), ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const std::string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_UTF8, cvtor.policy());
+	return record_stats(charset::utf8, charset::multibyte, text.size(), ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const char *s, std::size_t n)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, CP_UTF8);
+	return record_stats(charset::utf8, charset::multibyte, n, ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const char *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, CP_UTF8, cvtor.policy());
+	return record_stats(charset::utf8, charset::multibyte, n, ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const std::string &text)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_UTF8);
+	return record_stats(charset::utf8, charset::multibyte, text.size(), ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const std::string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_UTF8, cvtor.policy());
+	return record_stats(charset::utf8, charset::multibyte, text.size(), ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const wchar_t *s, std::size_t n)
+{
+	return record_stats(charset::widechar, charset::multibyte, n, ::to_mbs<std::vector<char>>(s, n, CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const wchar_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::multibyte, n, ::to_mbs<std::vector<char>>(s, n, CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const std::wstring &text)
+{
+	return record_stats(charset::widechar, charset::multibyte, text.size(), ::to_mbs<std::vector<char>>(text.c_str(), text.size(), CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const std::wstring &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::multibyte, text.size(), ::to_mbs<std::vector<char>>(text.c_str(), text.size(), CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const wchar_t *s, std::size_t n)
+{
+	return record_stats(charset::widechar, charset::multibyte, n, ::to_mbs<std::string>(s, n, CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const wchar_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::multibyte, n, ::to_mbs<std::string>(s, n, CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const std::wstring &text)
+{
+	return record_stats(charset::widechar, charset::multibyte, text.size(), ::to_mbs<std::string>(text.c_str(), text.size(), CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const std::wstring &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::multibyte, text.size(), ::to_mbs<std::string>(text.c_str(), text.size(), CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const char16_t *s, std::size_t n)
+{
+	return record_stats(charset::utf16, charset::multibyte, n, ::to_mbs<std::vector<char>>(s, n, CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const char16_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::multibyte, n, ::to_mbs<std::vector<char>>(s, n, CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const std::u16string &text)
+{
+	return record_stats(charset::utf16, charset::multibyte, text.size(), ::to_mbs<std::vector<char>>(text.c_str(), text.size(), CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const std::u16string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::multibyte, text.size(), ::to_mbs<std::vector<char>>(text.c_str(), text.size(), CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const char16_t *s, std::size_t n)
+{
+	return record_stats(charset::utf16, charset::multibyte, n, ::to_mbs<std::string>(s, n, CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const char16_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::multibyte, n, ::to_mbs<std::string>(s, n, CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const std::u16string &text)
+{
+	return record_stats(charset::utf16, charset::multibyte, text.size(), ::to_mbs<std::string>(text.c_str(), text.size(), CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const std::u16string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::multibyte, text.size(), ::to_mbs<std::string>(text.c_str(), text.size(), CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const char32_t *s, std::size_t n)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n);
+	return record_stats(charset::utf32, charset::multibyte, n, ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const char32_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, cvtor.policy());
+	return record_stats(charset::utf32, charset::multibyte, n, ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const std::u32string &text)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size());
+	return record_stats(charset::utf32, charset::multibyte, text.size(), ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const std::u32string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), cvtor.policy());
+	return record_stats(charset::utf32, charset::multibyte, text.size(), ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const char32_t *s, std::size_t n)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n);
+	return record_stats(charset::utf32, charset::multibyte, n, ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const char32_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, cvtor.policy());
+	return record_stats(charset::utf32, charset::multibyte, n, ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const std::u32string &text)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size());
+	return record_stats(charset::utf32, charset::multibyte, text.size(), ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::string extios::to_multibyte(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const std::u32string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), cvtor.policy());
+	return record_stats(charset::utf32, charset::multibyte, text.size(), ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_ACP));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const char *s, std::size_t n, bool isutf8)
+{
+	return record_stats(isutf8 ? charset::utf8 : charset::multibyte, charset::widechar, n, ::to_utf16<std::vector<wchar_t>>(s, n, isutf8 ? CP_UTF8 : CP_ACP));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const char *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::widechar, n, ::to_utf16<std::vector<wchar_t>>(s, n, CP_ACP));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::widechar, n, ::to_utf16<std::vector<wchar_t>>(s, n, CP_UTF8, cvtor.policy()));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const std::string &text, bool isutf8)
+{
+	return record_stats(isutf8 ? charset::utf8 : charset::multibyte, charset::widechar, text.size(), ::to_utf16<std::vector<wchar_t>>(text.c_str(), text.size(), isutf8 ? CP_UTF8 : CP_ACP));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const std::string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::widechar, text.size(), ::to_utf16<std::vector<wchar_t>>(text.c_str(), text.size(), CP_ACP));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const std::string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::widechar, text.size(), ::to_utf16<std::vector<wchar_t>>(text.c_str(), text.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::wstring extios::to_widechar(const char *s, std::size_t n, bool isutf8)
+{
+	return record_stats(isutf8 ? charset::utf8 : charset::multibyte, charset::widechar, n, ::to_utf16<std::wstring>(s, n, isutf8 ? CP_UTF8 : CP_ACP));
+}
+
+
+std::wstring extios::to_widechar(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const char *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::widechar, n, ::to_utf16<std::wstring>(s, n, CP_ACP));
+}
+
+
+std::wstring extios::to_widechar(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::widechar, n, ::to_utf16<std::wstring>(s, n, CP_UTF8, cvtor.policy()));
+}
+
+
+std::wstring extios::to_widechar(const std::string &text, bool isutf8)
+{
+	return record_stats(isutf8 ? charset::utf8 : charset::multibyte, charset::widechar, text.size(), ::to_utf16<std::wstring>(text.c_str(), text.size(), isutf8 ? CP_UTF8 : CP_ACP));
+}
+
+
+std::wstring extios::to_widechar(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const std::string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::widechar, text.size(), ::to_utf16<std::wstring>(text.c_str(), text.size(), CP_ACP));
+}
+
+
+std::wstring extios::to_widechar(const codecvtor<charset::utf8, charset::widechar> &cvtor, const std::string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::widechar, text.size(), ::to_utf16<std::wstring>(text.c_str(), text.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const char16_t *s, std::size_t n)
+{
+	return record_stats(charset::utf16, charset::widechar, n, std::vector<wchar_t>(s, s + n));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::widechar, n, std::vector<wchar_t>(s, s + n));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const std::u16string &text)
+{
+	return record_stats(charset::utf16, charset::widechar, text.size(), std::vector<wchar_t>(text.begin(), text.end()));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const std::u16string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::widechar, text.size(), std::vector<wchar_t>(text.begin(), text.end()));
+}
+
+
+std::wstring extios::to_widechar(const char16_t *s, std::size_t n)
+{
+	return record_stats(charset::utf16, charset::widechar, n, std::wstring(s, s + n));
+}
+
+
+std::wstring extios::to_widechar(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::widechar, n, std::wstring(s, s + n));
+}
+
+
+std::wstring extios::to_widechar(const std::u16string &text)
+{
+	return record_stats(charset::utf16, charset::widechar, text.size(), std::wstring(text.begin(), text.end()));
+}
+
+
+std::wstring extios::to_widechar(const codecvtor<charset::utf16, charset::widechar> &cvtor, const std::u16string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::widechar, text.size(), std::wstring(text.begin(), text.end()));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const char32_t *s, std::size_t n)
+{
+	return record_stats(charset::utf32, charset::widechar, n, ::to_utf16<std::vector<wchar_t>>(s, n));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::widechar, n, ::to_utf16<std::vector<wchar_t>>(s, n, cvtor.policy()));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const std::u32string &text)
+{
+	return record_stats(charset::utf32, charset::widechar, text.size(), ::to_utf16<std::vector<wchar_t>>(text.c_str(), text.size()));
+}
+
+
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const std::u32string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::widechar, text.size(), ::to_utf16<std::vector<wchar_t>>(text.c_str(), text.size(), cvtor.policy()));
+}
+
+
+std::wstring extios::to_widechar(const char32_t *s, std::size_t n)
+{
+	return record_stats(charset::utf32, charset::widechar, n, ::to_utf16<std::wstring>(s, n));
+}
+
+
+std::wstring extios::to_widechar(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::widechar, n, ::to_utf16<std::wstring>(s, n, cvtor.policy()));
+}
+
+
+std::wstring extios::to_widechar(const std::u32string &text)
+{
+	return record_stats(charset::utf32, charset::widechar, text.size(), ::to_utf16<std::wstring>(text.c_str(), text.size()));
+}
+
+
+std::wstring extios::to_widechar(const codecvtor<charset::utf32, charset::widechar> &cvtor, const std::u32string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::widechar, text.size(), ::to_utf16<std::wstring>(text.c_str(), text.size(), cvtor.policy()));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const char *s, std::size_t n)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, CP_ACP);
+	return record_stats(charset::multibyte, charset::utf8, n, ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_UTF8));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const char *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, CP_ACP);
+	return record_stats(charset::multibyte, charset::utf8, n, ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const std::string &text)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_ACP);
+	return record_stats(charset::multibyte, charset::utf8, text.size(), ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_UTF8));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const std::string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_ACP);
+	return record_stats(charset::multibyte, charset::utf8, text.size(), ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::string extios::to_utf8(const char *s, std::size_t n)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, CP_ACP);
+	return record_stats(charset::multibyte, charset::utf8, n, ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_UTF8));
+}
+
+
+std::string extios::to_utf8(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const char *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, CP_ACP);
+	return record_stats(charset::multibyte, charset::utf8, n, ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::string extios::to_utf8(const std::string &text)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_ACP);
+	return record_stats(charset::multibyte, charset::utf8, text.size(), ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_UTF8));
+}
+
+
+std::string extios::to_utf8(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const std::string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_ACP);
+	return record_stats(charset::multibyte, charset::utf8, text.size(), ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const wchar_t *s, std::size_t n)
+{
+	return record_stats(charset::widechar, charset::utf8, n, ::to_mbs<std::vector<char>>(s, n, CP_UTF8));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf8, n, ::to_mbs<std::vector<char>>(s, n, CP_UTF8, cvtor.policy()));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const std::wstring &text)
+{
+	return record_stats(charset::widechar, charset::utf8, text.size(), ::to_mbs<std::vector<char>>(text.c_str(), text.size(), CP_UTF8));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const std::wstring &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf8, text.size(), ::to_mbs<std::vector<char>>(text.c_str(), text.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::string extios::to_utf8(const wchar_t *s, std::size_t n)
+{
+	return record_stats(charset::widechar, charset::utf8, n, ::to_mbs<std::string>(s, n, CP_UTF8));
+}
+
+
+std::string extios::to_utf8(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf8, n, ::to_mbs<std::string>(s, n, CP_UTF8, cvtor.policy()));
+}
+
+
+std::string extios::to_utf8(const std::wstring &text)
+{
+	return record_stats(charset::widechar, charset::utf8, text.size(), ::to_mbs<std::string>(text.c_str(), text.size(), CP_UTF8));
+}
+
+
+std::string extios::to_utf8(const codecvtor<charset::widechar, charset::utf8> &cvtor, const std::wstring &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf8, text.size(), ::to_mbs<std::string>(text.c_str(), text.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const char16_t *s, std::size_t n)
+{
+	return record_stats(charset::utf16, charset::utf8, n, ::to_mbs<std::vector<char>>(s, n, CP_UTF8));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf8, n, ::to_mbs<std::vector<char>>(s, n, CP_UTF8, cvtor.policy()));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const std::u16string &text)
+{
+	return record_stats(charset::utf16, charset::utf8, text.size(), ::to_mbs<std::vector<char>>(text.c_str(), text.size(), CP_UTF8));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const std::u16string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf8, text.size(), ::to_mbs<std::vector<char>>(text.c_str(), text.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::string extios::to_utf8(const char16_t *s, std::size_t n)
+{
+	return record_stats(charset::utf16, charset::utf8, n, ::to_mbs<std::string>(s, n, CP_UTF8));
+}
+
+
+std::string extios::to_utf8(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf8, n, ::to_mbs<std::string>(s, n, CP_UTF8, cvtor.policy()));
+}
+
+
+std::string extios::to_utf8(const std::u16string &text)
+{
+	return record_stats(charset::utf16, charset::utf8, text.size(), ::to_mbs<std::string>(text.c_str(), text.size(), CP_UTF8));
+}
+
+
+std::string extios::to_utf8(const codecvtor<charset::utf16, charset::utf8> &cvtor, const std::u16string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf8, text.size(), ::to_mbs<std::string>(text.c_str(), text.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const char32_t *s, std::size_t n)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n);
+	return record_stats(charset::utf32, charset::utf8, n, ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_UTF8));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, cvtor.policy());
+	return record_stats(charset::utf32, charset::utf8, n, ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const std::u32string &text)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size());
+	return record_stats(charset::utf32, charset::utf8, text.size(), ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_UTF8));
+}
+
+
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const std::u32string &text)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), cvtor.policy());
+	return record_stats(charset::utf32, charset::utf8, text.size(), ::to_mbs<std::vector<char>>(buffer.data(), buffer.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::string extios::to_utf8(const char32_t *s, std::size_t n)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n);
+	return record_stats(charset::utf32, charset::utf8, n, ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_UTF8));
+}
+
+
+std::string extios::to_utf8(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, std::size_t n)
+{
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, cvtor.policy());
+	return record_stats(charset::utf32, charset::utf8, n, ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_UTF8, cvtor.policy()));
+}
+
+
+std::string extios::to_utf8(const std::u32string &text)
+{
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size());
+	return record_stats(charset::utf32, charset::utf8, text.size(), ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_UTF8));
 }
 
 
-extios::codecvtor<extios::charset::multibyte, extios::charset::utf32>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::string extios::to_utf8(const codecvtor<charset::utf32, charset::utf8> &cvtor, const std::u32string &text)
 {
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), cvtor.policy());
+	return record_stats(charset::utf32, charset::utf8, text.size(), ::to_mbs<std::string>(buffer.data(), buffer.size(), CP_UTF8, cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::widechar, extios::charset::multibyte>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::vector<char16_t> extios::to_utf16_buffer(const char *s, std::size_t n, bool isutf8)
 {
+	return record_stats(isutf8 ? charset::utf8 : charset::multibyte, charset::utf16, n, ::to_utf16<std::vector<char16_t>>(s, n, isutf8 ? CP_UTF8 : CP_ACP));
 }
 
 
-extios::codecvtor<extios::charset::widechar, extios::charset::utf8>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const char *s, std::size_t n)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::utf16, n, ::to_utf16<std::vector<char16_t>>(s, n, CP_ACP));
 }
 
 
-extios::codecvtor<extios::charset::widechar, extios::charset::utf16>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, std::size_t n)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf16, n, ::to_utf16<std::vector<char16_t>>(s, n, CP_UTF8, cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::widechar, extios::charset::utf32>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::vector<char16_t> extios::to_utf16_buffer(const std::string &text, bool isutf8)
 {
+	return record_stats(isutf8 ? charset::utf8 : charset::multibyte, charset::utf16, text.size(), ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), isutf8 ? CP_UTF8 : CP_ACP));
 }
 
 
-extios::codecvtor<extios::charset::utf8, extios::charset::multibyte>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const std::string &text)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::utf16, text.size(), ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_ACP));
 }
 
 
-extios::codecvtor<extios::charset::utf8, extios::charset::widechar>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const std::string &text)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf16, text.size(), ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_UTF8, cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::utf8, extios::charset::utf16>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::u16string extios::to_utf16(const char *s, std::size_t n, bool isutf8)
 {
+	return record_stats(isutf8 ? charset::utf8 : charset::multibyte, charset::utf16, n, ::to_utf16<std::u16string>(s, n, isutf8 ? CP_UTF8 : CP_ACP));
 }
 
 
-extios::codecvtor<extios::charset::utf8, extios::charset::utf32>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::u16string extios::to_utf16(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const char *s, std::size_t n)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::utf16, n, ::to_utf16<std::u16string>(s, n, CP_ACP));
 }
 
 
-extios::codecvtor<extios::charset::utf16, extios::charset::multibyte>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::u16string extios::to_utf16(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, std::size_t n)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf16, n, ::to_utf16<std::u16string>(s, n, CP_UTF8, cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::utf16, extios::charset::widechar>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::u16string extios::to_utf16(const std::string &text, bool isutf8)
 {
+	return record_stats(isutf8 ? charset::utf8 : charset::multibyte, charset::utf16, text.size(), ::to_utf16<std::u16string>(text.c_str(), text.size(), isutf8 ? CP_UTF8 : CP_ACP));
 }
 
 
-extios::codecvtor<extios::charset::utf16, extios::charset::utf8>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::u16string extios::to_utf16(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const std::string &text)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::utf16, text.size(), ::to_utf16<std::u16string>(text.c_str(), text.size(), CP_ACP));
 }
 
 
-extios::codecvtor<extios::charset::utf16, extios::charset::utf32>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::u16string extios::to_utf16(const codecvtor<charset::utf8, charset::utf16> &cvtor, const std::string &text)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf16, text.size(), ::to_utf16<std::u16string>(text.c_str(), text.size(), CP_UTF8, cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::utf32, extios::charset::multibyte>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::vector<char16_t> extios::to_utf16_buffer(const wchar_t *s, std::size_t n)
 {
+	return record_stats(charset::widechar, charset::utf16, n, std::vector<char16_t>(s, s + n));
 }
 
 
-extios::codecvtor<extios::charset::utf32, extios::charset::widechar>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, std::size_t n)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf16, n, std::vector<char16_t>(s, s + n));
 }
 
 
-extios::codecvtor<extios::charset::utf32, extios::charset::utf8>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::vector<char16_t> extios::to_utf16_buffer(const std::wstring &text)
 {
+	return record_stats(charset::widechar, charset::utf16, text.size(), std::vector<char16_t>(text.begin(), text.end()));
 }
 
 
-extios::codecvtor<extios::charset::utf32, extios::charset::utf16>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>())
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const std::wstring &text)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf16, text.size(), std::vector<char16_t>(text.begin(), text.end()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const char *s, unsigned int n)
+std::u16string extios::to_utf16(const wchar_t *s, std::size_t n)
 {
-	throw_if_string_too_long(n);
-	auto buffer = ::to_utf16<char16_t>(s, n, CP_UTF8);
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_ACP);
+	return record_stats(charset::widechar, charset::utf16, n, std::u16string(s, s + n));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const char *s, unsigned int n)
+std::u16string extios::to_utf16(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	auto buffer = ::to_utf16<char16_t>(s, n, CP_UTF8);
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_ACP);
+	return record_stats(charset::widechar, charset::utf16, n, std::u16string(s, s + n));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const std::string &text)
+std::u16string extios::to_utf16(const std::wstring &text)
 {
-	throw_if_string_too_long(text.size());
-	auto buffer = ::to_utf16<char16_t>(text.c_str(), static_cast<int>(text.size()), CP_UTF8);
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_ACP);
+	return record_stats(charset::widechar, charset::utf16, text.size(), std::u16string(text.begin(), text.end()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const std::string &text)
+std::u16string extios::to_utf16(const codecvtor<charset::widechar, charset::utf16> &cvtor, const std::wstring &text)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	auto buffer = ::to_utf16<char16_t>(text.c_str(), static_cast<int>(text.size()), CP_UTF8);
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_ACP);
+	return record_stats(charset::widechar, charset::utf16, text.size(), std::u16string(text.begin(), text.end()));
 }
 
 
-std::string extios::to_multibyte(const char *s, unsigned int n)
+std::vector<char16_t> extios::to_utf16_buffer(const char32_t *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf32, charset::utf16, n, ::to_utf16<std::vector<char16_t>>(s, n));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const char *s, unsigned int n)
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::utf16, n, ::to_utf16<std::vector<char16_t>>(s, n, cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const std::string &text)
+std::vector<char16_t> extios::to_utf16_buffer(const std::u32string &text)
 {
-	auto buffer = to_multibyte_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf32, charset::utf16, text.size(), ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const std::string &text)
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const std::u32string &text)
 {
-	auto buffer = to_multibyte_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::utf16, text.size(), ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const wchar_t *s, unsigned int n)
+std::u16string extios::to_utf16(const char32_t *s, std::size_t n)
 {
-	throw_if_string_too_long(n);
-	return ::to_mbs(s, n, CP_ACP);
+	return record_stats(charset::utf32, charset::utf16, n, ::to_utf16<std::u16string>(s, n));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const wchar_t *s, unsigned int n)
+std::u16string extios::to_utf16(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::to_mbs(s, n, CP_ACP);
+	return record_stats(charset::utf32, charset::utf16, n, ::to_utf16<std::u16string>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const std::wstring &text)
+std::u16string extios::to_utf16(const std::u32string &text)
 {
-	throw_if_string_too_long(text.size());
-	return ::to_mbs(text.c_str(), static_cast<int>(text.size()), CP_ACP);
+	return record_stats(charset::utf32, charset::utf16, text.size(), ::to_utf16<std::u16string>(text.c_str(), text.size()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const std::wstring &text)
+std::u16string extios::to_utf16(const codecvtor<charset::utf32, charset::utf16> &cvtor, const std::u32string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::to_mbs(text.c_str(), static_cast<int>(text.size()), CP_ACP);
+	return record_stats(charset::utf32, charset::utf16, text.size(), ::to_utf16<std::u16string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const wchar_t *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const char *s, std::size_t n, bool isutf8)
 {
-	auto buffer = to_multibyte_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, isutf8 ? CP_UTF8 : CP_ACP);
+	return record_stats(isutf8 ? charset::utf8 : charset::multibyte, charset::utf32, n, ::to_utf32<std::vector<char32_t>>(buffer.data(), buffer.size()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const wchar_t *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const char *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, CP_ACP);
+	return record_stats(charset::multibyte, charset::utf32, n, ::to_utf32<std::vector<char32_t>>(buffer.data(), buffer.size(), cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const std::wstring &text)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, CP_UTF8, cvtor.policy());
+	return record_stats(charset::utf8, charset::utf32, n, ::to_utf32<std::vector<char32_t>>(buffer.data(), buffer.size(), cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const std::wstring &text)
+std::vector<char32_t> extios::to_utf32_buffer(const std::string &text, bool isutf8)
 {
-	auto buffer = to_multibyte_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), isutf8 ? CP_UTF8 : CP_ACP);
+	return record_stats(isutf8 ? charset::utf8 : charset::multibyte, charset::utf32, text.size(), ::to_utf32<std::vector<char32_t>>(buffer.data(), buffer.size()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const char16_t *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const std::string &text)
 {
-	throw_if_string_too_long(n);
-	return ::to_mbs(s, n, CP_ACP);
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_ACP);
+	return record_stats(charset::multibyte, charset::utf32, text.size(), ::to_utf32<std::vector<char32_t>>(buffer.data(), buffer.size(), cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const char16_t *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const std::string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::to_mbs(s, n, CP_ACP);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_UTF8, cvtor.policy());
+	return record_stats(charset::utf8, charset::utf32, text.size(), ::to_utf32<std::vector<char32_t>>(buffer.data(), buffer.size(), cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const std::u16string &text)
+std::u32string extios::to_utf32(const char *s, std::size_t n, bool isutf8)
 {
-	throw_if_string_too_long(text.size());
-	return ::to_mbs(text.c_str(), static_cast<int>(text.size()), CP_ACP);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, isutf8 ? CP_UTF8 : CP_ACP);
+	return record_stats(isutf8 ? charset::utf8 : charset::multibyte, charset::utf32, n, ::to_utf32<std::u32string>(buffer.data(), buffer.size()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const std::u16string &text)
+std::u32string extios::to_utf32(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const char *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::to_mbs(text.c_str(), static_cast<int>(text.size()), CP_ACP);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, CP_ACP);
+	return record_stats(charset::multibyte, charset::utf32, n, ::to_utf32<std::u32string>(buffer.data(), buffer.size(), cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const char16_t *s, unsigned int n)
+std::u32string extios::to_utf32(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n, CP_UTF8, cvtor.policy());
+	return record_stats(charset::utf8, charset::utf32, n, ::to_utf32<std::u32string>(buffer.data(), buffer.size(), cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const char16_t *s, unsigned int n)
+std::u32string extios::to_utf32(const std::string &text, bool isutf8)
 {
-	auto buffer = to_multibyte_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), isutf8 ? CP_UTF8 : CP_ACP);
+	return record_stats(isutf8 ? charset::utf8 : charset::multibyte, charset::utf32, text.size(), ::to_utf32<std::u32string>(buffer.data(), buffer.size()));
 }
 
 
-std::string extios::to_multibyte(const std::u16string &text)
+std::u32string extios::to_utf32(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const std::string &text)
 {
-	auto buffer = to_multibyte_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_ACP);
+	return record_stats(charset::multibyte, charset::utf32, text.size(), ::to_utf32<std::u32string>(buffer.data(), buffer.size(), cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const std::u16string &text)
+std::u32string extios::to_utf32(const codecvtor<charset::utf8, charset::utf32> &cvtor, const std::string &text)
 {
-	auto buffer = to_multibyte_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size(), CP_UTF8, cvtor.policy());
+	return record_stats(charset::utf8, charset::utf32, text.size(), ::to_utf32<std::u32string>(buffer.data(), buffer.size(), cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const char32_t *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const wchar_t *s, std::size_t n)
 {
-	throw_if_string_too_long(n);
-	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n);
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_ACP);
+	return record_stats(charset::widechar, charset::utf32, n, ::to_utf32<std::vector<char32_t>>(s, n));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const char32_t *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n);
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_ACP);
+	return record_stats(charset::widechar, charset::utf32, n, ::to_utf32<std::vector<char32_t>>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const std::u32string &text)
+std::vector<char32_t> extios::to_utf32_buffer(const std::wstring &text)
 {
-	throw_if_string_too_long(text.size());
-	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size());
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_ACP);
+	return record_stats(charset::widechar, charset::utf32, text.size(), ::to_utf32<std::vector<char32_t>>(text.c_str(), text.size()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const std::u32string &text)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const std::wstring &text)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size());
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_ACP);
+	return record_stats(charset::widechar, charset::utf32, text.size(), ::to_utf32<std::vector<char32_t>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const char32_t *s, unsigned int n)
+std::u32string extios::to_utf32(const wchar_t *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::widechar, charset::utf32, n, ::to_utf32<std::u32string>(s, n));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const char32_t *s, unsigned int n)
+std::u32string extios::to_utf32(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf32, n, ::to_utf32<std::u32string>(s, n, cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const std::u32string &text)
+std::u32string extios::to_utf32(const std::wstring &text)
 {
-	auto buffer = to_multibyte_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::widechar, charset::utf32, text.size(), ::to_utf32<std::u32string>(text.c_str(), text.size()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const std::u32string &text)
+std::u32string extios::to_utf32(const codecvtor<charset::widechar, charset::utf32> &cvtor, const std::wstring &text)
 {
-	auto buffer = to_multibyte_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf32, text.size(), ::to_utf32<std::u32string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const char *s, unsigned int n, bool isutf8)
+std::vector<char32_t> extios::to_utf32_buffer(const char16_t *s, std::size_t n)
 {
-	throw_if_string_too_long(n);
-	return ::to_utf16<wchar_t>(s, n, isutf8 ? CP_UTF8 : CP_ACP);
+	return record_stats(charset::utf16, charset::utf32, n, ::to_utf32<std::vector<char32_t>>(s, n));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const char *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::to_utf16<wchar_t>(s, n, CP_ACP);
+	return record_stats(charset::utf16, charset::utf32, n, ::to_utf32<std::vector<char32_t>>(s, n, cvtor.policy()));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const std::u16string &text)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::to_utf16<wchar_t>(s, n, CP_UTF8);
+	return record_stats(charset::utf16, charset::utf32, text.size(), ::to_utf32<std::vector<char32_t>>(text.c_str(), text.size()));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const std::string &text, bool isutf8)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const std::u16string &text)
 {
-	throw_if_string_too_long(text.size());
-	return ::to_utf16<wchar_t>(text.c_str(), static_cast<int>(text.size()), isutf8 ? CP_UTF8 : CP_ACP);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf32, text.size(), ::to_utf32<std::vector<char32_t>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const std::string &text)
+std::u32string extios::to_utf32(const char16_t *s, std::size_t n)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::to_utf16<wchar_t>(text.c_str(), static_cast<int>(text.size()), CP_ACP);
+	return record_stats(charset::utf16, charset::utf32, n, ::to_utf32<std::u32string>(s, n));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const std::string &text)
+std::u32string extios::to_utf32(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::to_utf16<wchar_t>(text.c_str(), static_cast<int>(text.size()), CP_UTF8);
+	return record_stats(charset::utf16, charset::utf32, n, ::to_utf32<std::u32string>(s, n, cvtor.policy()));
 }
 
 
-std::wstring extios::to_widechar(const char *s, unsigned int n, bool isutf8)
+std::u32string extios::to_utf32(const std::u16string &text)
 {
-	auto buffer = to_widechar_buffer(s, n, isutf8);
-	return std::wstring(buffer.begin(), buffer.end());
+	return record_stats(charset::utf16, charset::utf32, text.size(), ::to_utf32<std::u32string>(text.c_str(), text.size()));
 }
 
 
-std::wstring extios::to_widechar(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const char *s, unsigned int n)
+std::u32string extios::to_utf32(const codecvtor<charset::utf16, charset::utf32> &cvtor, const std::u16string &text)
 {
-	auto buffer = to_widechar_buffer(cvtor, s, n);
-	return std::wstring(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf32, text.size(), ::to_utf32<std::u32string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::wstring extios::to_widechar(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, unsigned int n)
+// 抛出文件操作失败的异常
+// error 错误码
+// what 失败的操作
+[[noreturn]] static void throw_file_error(DWORD error, const char *what)
 {
-	auto buffer = to_widechar_buffer(cvtor, s, n);
-	return std::wstring(buffer.begin(), buffer.end());
+	throw std::system_error(static_cast<int>(error), std::system_category(), what);
 }
 
 
-std::wstring extios::to_widechar(const std::string &text, bool isutf8)
+// 只读映射到内存的输入文件, 不能映射的文件(如管道)整体读入内存
+struct mapped_file
 {
-	auto buffer = to_widechar_buffer(text, isutf8);
-	return std::wstring(buffer.begin(), buffer.end());
-}
+	// path 文件路径
+	explicit mapped_file(const char *path)
+		: data(nullptr)
+		, size(0)
+		, file(::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr))
+	{
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			::throw_file_error(::GetLastError(), "打开输入文件失败");
+		}
 
+		if (::GetFileType(file) == FILE_TYPE_DISK)
+		{
+			LARGE_INTEGER length;
+			if (!::GetFileSizeEx(file, &length))
+			{
+				auto error = ::GetLastError();
+				::CloseHandle(file);
+				::throw_file_error(error, "获取输入文件信息失败");
+			}
+			if (static_cast<unsigned long long>(length.QuadPart) > static_cast<unsigned long long>(static_cast<std::size_t>(-1)))
+			{
+				::CloseHandle(file);
+				::throw_file_error(ERROR_FILE_TOO_LARGE, "输入文件太大");
+			}
+			size = static_cast<std::size_t>(length.QuadPart);
+			if (size != 0)
+			{
+				// 文件映射和映射的视图都保持文件打开, 映射后即可关闭句柄
+				auto mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				auto view = mapping != nullptr ? ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+				auto error = ::GetLastError();
+				if (mapping != nullptr)
+				{
+					::CloseHandle(mapping);
+				}
+				if (view == nullptr)
+				{
+					::CloseHandle(file);
+					::throw_file_error(error, "映射输入文件失败");
+				}
+				data = static_cast<const char *>(view);
+			}
+		}
+		else
+		{
+			for (;;)
+			{
+				if (buffer.size() - size < ::file_read_size)
+				{
+					buffer.resize(size + ::file_read_size);
+				}
+				DWORD length = 0;
+				auto count = static_cast<DWORD>(std::min<std::size_t>(buffer.size() - size, 0x40000000));
+				if (!::ReadFile(file, buffer.data() + size, count, &length, nullptr))
+				{
+					auto error = ::GetLastError();
+					if (error == ERROR_BROKEN_PIPE)
+					{
+						break;
+					}
+					::CloseHandle(file);
+					::throw_file_error(error, "读取输入文件失败");
+				}
+				if (length == 0)
+				{
+					break;
+				}
+				size += length;
+			}
+			data = buffer.data();
+		}
+	}
 
-std::wstring extios::to_widechar(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const std::string &text)
-{
-	auto buffer = to_widechar_buffer(cvtor, text);
-	return std::wstring(buffer.begin(), buffer.end());
-}
+	mapped_file(const mapped_file &) = delete;
+	mapped_file & operator=(const mapped_file &) = delete;
 
+	~mapped_file(void)
+	{
+		if (buffer.empty() && data != nullptr)
+		{
+			::UnmapViewOfFile(data);
+		}
+		::CloseHandle(file);
+	}
 
-std::wstring extios::to_widechar(const codecvtor<charset::utf8, charset::widechar> &cvtor, const std::string &text)
-{
-	auto buffer = to_widechar_buffer(cvtor, text);
-	return std::wstring(buffer.begin(), buffer.end());
-}
+	const char *data; // 文件内容的首地址
+	std::size_t size; // 文件的字节数
+	std::vector<char> buffer; // 不能映射时读入的文件内容
+	HANDLE file; // 文件句柄, 打开期间其他程序不能写入, 也就不能作为输出文件
+};
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const char16_t *s, unsigned int n)
+// 转换结果的输出文件
+struct output_file
 {
-	return std::vector<wchar_t>(s, s + n);
-}
+	// path 文件路径, 已存在时清空原有内容
+	// input 输入文件, 输入文件以只读共享方式打开, 输出到同一个文件时打开失败
+	output_file(const char *path, const mapped_file &)
+		: file(::CreateFileA(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, nullptr))
+	{
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			::throw_file_error(::GetLastError(), "打开输出文件失败");
+		}
+	}
 
+	output_file(const output_file &) = delete;
+	output_file & operator=(const output_file &) = delete;
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, unsigned int n)
-{
-	throw_if_cvtor_null(cvtor);
-	return std::vector<wchar_t>(s, s + n);
-}
+	~output_file(void)
+	{
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			::CloseHandle(file);
+		}
+	}
 
+	// 完整写入n个字节
+	// s 需要写入的数据
+	// n 字节数
+	void write(const void *s, std::size_t n)
+	{
+		auto p = static_cast<const char *>(s);
+		while (n != 0)
+		{
+			DWORD length = 0;
+			auto count = static_cast<DWORD>(std::min<std::size_t>(n, 0x40000000));
+			if (!::WriteFile(file, p, count, &length, nullptr))
+			{
+				::throw_file_error(::GetLastError(), "写入输出文件失败");
+			}
+			p += length;
+			n -= length;
+		}
+	}
 
-std::vector<wchar_t> extios::to_widechar_buffer(const std::u16string &text)
-{
-	return std::vector<wchar_t>(text.begin(), text.end());
-}
+	// 关闭文件
+	void close(void)
+	{
+		auto result = ::CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+		if (!result)
+		{
+			::throw_file_error(::GetLastError(), "关闭输出文件失败");
+		}
+	}
 
+	HANDLE file; // 文件句柄
+};
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const std::u16string &text)
-{
-	throw_if_cvtor_null(cvtor);
-	return std::vector<wchar_t>(text.begin(), text.end());
-}
 
+#else // !_MSC_VER
+
+#include <iconv.h> // iconv_open iconv iconv_close
+#include <cstring> // std::strerror
+#include <cerrno> // cerrno
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap munmap madvise
+#include <sys/stat.h> // fstat
+#include <unistd.h> // read write close ftruncate
+
+// 使用本机字节序的UTF-16/UTF-32, 指定字节序后iconv不会输出BOM
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define EXTIOS_ICONV_UTF16 "UTF-16BE"
+#define EXTIOS_ICONV_UTF32 "UTF-32BE"
+#else // __BYTE_ORDER__
+#define EXTIOS_ICONV_UTF16 "UTF-16LE"
+#define EXTIOS_ICONV_UTF32 "UTF-32LE"
+#endif // __BYTE_ORDER__
 
-std::wstring extios::to_widechar(const char16_t *s, unsigned int n)
+struct extios::codecvtor_base::member_data
 {
-	return std::wstring(s, s + n);
-}
+	iconv_t cd;
+
+	member_data(const char *fromcode, const char *tocode);
+	~member_data(void);
+	member_data(const member_data &) = delete;
+	member_data(member_data &&) = delete;
+	member_data & operator=(const member_data &) = delete;
+	member_data & operator=(member_data &&) = delete;
+};
 
 
-std::wstring extios::to_widechar(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, unsigned int n)
+extios::codecvtor_base::member_data::member_data(const char *fromcode, const char *tocode)
+	: cd(::iconv_open(tocode, fromcode))
 {
-	throw_if_cvtor_null(cvtor);
-	return std::wstring(s, s + n);
+	if (cd == reinterpret_cast<iconv_t>(-1))
+	{
+		throw std::invalid_argument(std::strerror(errno));
+	}
 }
 
 
-std::wstring extios::to_widechar(const std::u16string &text)
+extios::codecvtor_base::member_data::~member_data(void)
 {
-	return std::wstring(text.begin(), text.end());
+	if (cd != reinterpret_cast<iconv_t>(-1))
+	{
+		::iconv_close(cd);
+	}
 }
 
 
-std::wstring extios::to_widechar(const codecvtor<charset::utf16, charset::widechar> &cvtor, const std::u16string &text)
+void * extios::codecvtor_base::handle(void) const noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	return std::wstring(text.begin(), text.end());
+	return m_data->cd;
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const char32_t *s, unsigned int n)
+extios::codecvtor<extios::charset::multibyte, extios::charset::widechar>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>("UTF-8", EXTIOS_ICONV_UTF32), policy)
 {
-	return ::to_utf16<std::vector<wchar_t>>(s, n);
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, unsigned int n)
+extios::codecvtor<extios::charset::multibyte, extios::charset::utf8>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>("UTF-8", "UTF-8"), policy)
 {
-	throw_if_cvtor_null(cvtor);
-	return ::to_utf16<std::vector<wchar_t>>(s, n);
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const std::u32string &text)
+extios::codecvtor<extios::charset::multibyte, extios::charset::utf16>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>("UTF-8", EXTIOS_ICONV_UTF16), policy)
 {
-	return ::to_utf16<std::vector<wchar_t>>(text.c_str(), text.size());
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const std::u32string &text)
+extios::codecvtor<extios::charset::multibyte, extios::charset::utf32>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>("UTF-8", EXTIOS_ICONV_UTF32), policy)
 {
-	throw_if_cvtor_null(cvtor);
-	return ::to_utf16<std::vector<wchar_t>>(text.c_str(), text.size());
 }
 
 
-std::wstring extios::to_widechar(const char32_t *s, unsigned int n)
+extios::codecvtor<extios::charset::widechar, extios::charset::multibyte>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(EXTIOS_ICONV_UTF32, "UTF-8"), policy)
 {
-	return ::to_utf16<std::wstring>(s, n);
 }
 
 
-std::wstring extios::to_widechar(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, unsigned int n)
+extios::codecvtor<extios::charset::widechar, extios::charset::utf8>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(EXTIOS_ICONV_UTF32, "UTF-8"), policy)
 {
-	throw_if_cvtor_null(cvtor);
-	return ::to_utf16<std::wstring>(s, n);
 }
 
 
-std::wstring extios::to_widechar(const std::u32string &text)
+extios::codecvtor<extios::charset::widechar, extios::charset::utf16>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(EXTIOS_ICONV_UTF32, EXTIOS_ICONV_UTF16), policy)
 {
-	return ::to_utf16<std::wstring>(text.c_str(), text.size());
 }
 
 
-std::wstring extios::to_widechar(const codecvtor<charset::utf32, charset::widechar> &cvtor, const std::u32string &text)
+extios::codecvtor<extios::charset::widechar, extios::charset::utf32>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(EXTIOS_ICONV_UTF32, EXTIOS_ICONV_UTF32), policy)
 {
-	throw_if_cvtor_null(cvtor);
-	return ::to_utf16<std::wstring>(text.c_str(), text.size());
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const char *s, unsigned int n)
+extios::codecvtor<extios::charset::utf8, extios::charset::multibyte>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>("UTF-8", "UTF-8"), policy)
 {
-	throw_if_string_too_long(n);
-	auto buffer = ::to_utf16<char16_t>(s, n, CP_ACP);
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_UTF8);
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const char *s, unsigned int n)
+extios::codecvtor<extios::charset::utf8, extios::charset::widechar>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>("UTF-8", EXTIOS_ICONV_UTF32), policy)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	auto buffer = ::to_utf16<char16_t>(s, n, CP_ACP);
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_UTF8);
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const std::string &text)
+extios::codecvtor<extios::charset::utf8, extios::charset::utf16>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>("UTF-8", EXTIOS_ICONV_UTF16), policy)
 {
-	throw_if_string_too_long(text.size());
-	auto buffer = ::to_utf16<char16_t>(text.c_str(), static_cast<int>(text.size()), CP_ACP);
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_UTF8);
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const std::string &text)
+extios::codecvtor<extios::charset::utf8, extios::charset::utf32>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>("UTF-8", EXTIOS_ICONV_UTF32), policy)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	auto buffer = ::to_utf16<char16_t>(text.c_str(), static_cast<int>(text.size()), CP_ACP);
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_UTF8);
 }
 
 
-std::string extios::to_utf8(const char *s, unsigned int n)
+extios::codecvtor<extios::charset::utf16, extios::charset::multibyte>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(EXTIOS_ICONV_UTF16, "UTF-8"), policy)
 {
-	auto buffer = to_utf8_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const char *s, unsigned int n)
+extios::codecvtor<extios::charset::utf16, extios::charset::widechar>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(EXTIOS_ICONV_UTF16, EXTIOS_ICONV_UTF32), policy)
 {
-	auto buffer = to_utf8_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
 }
 
 
-std::string extios::to_utf8(const std::string &text)
+extios::codecvtor<extios::charset::utf16, extios::charset::utf8>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(EXTIOS_ICONV_UTF16, "UTF-8"), policy)
 {
-	auto buffer = to_utf8_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const std::string &text)
+extios::codecvtor<extios::charset::utf16, extios::charset::utf32>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(EXTIOS_ICONV_UTF16, EXTIOS_ICONV_UTF32), policy)
 {
-	auto buffer = to_utf8_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const wchar_t *s, unsigned int n)
+extios::codecvtor<extios::charset::utf32, extios::charset::multibyte>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(EXTIOS_ICONV_UTF32, "UTF-8"), policy)
 {
-	throw_if_string_too_long(n);
-	return ::to_mbs(s, n, CP_UTF8);
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, unsigned int n)
+extios::codecvtor<extios::charset::utf32, extios::charset::widechar>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(EXTIOS_ICONV_UTF32, EXTIOS_ICONV_UTF32), policy)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::to_mbs(s, n, CP_UTF8);
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const std::wstring &text)
+extios::codecvtor<extios::charset::utf32, extios::charset::utf8>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(EXTIOS_ICONV_UTF32, "UTF-8"), policy)
 {
-	throw_if_string_too_long(text.size());
-	return ::to_mbs(text.c_str(), static_cast<int>(text.size()), CP_UTF8);
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const std::wstring &text)
+extios::codecvtor<extios::charset::utf32, extios::charset::utf16>::codecvtor(error_policy policy)
+	: codecvtor_base(std::make_shared<member_data>(EXTIOS_ICONV_UTF32, EXTIOS_ICONV_UTF16), policy)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::to_mbs(text.c_str(), static_cast<int>(text.size()), CP_UTF8);
 }
 
 
-std::string extios::to_utf8(const wchar_t *s, unsigned int n)
+static std::size_t iconvert(iconv_t cd, char *inbuf, std::size_t inbytes, char *outbuf, std::size_t outbytes)
 {
-	auto buffer = to_utf8_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	// 复用的转换描述符需要先恢复到初始状态
+	::iconv(cd, nullptr, nullptr, nullptr, nullptr);
+	if (::iconv(cd, &inbuf, &inbytes, &outbuf, &outbytes) == static_cast<std::size_t>(-1))
+	{
+		if (errno == EILSEQ || errno == EINVAL)
+		{
+			count_malformed();
+		}
+		throw std::invalid_argument(std::strerror(errno));
+	}
+	return outbytes;
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, unsigned int n)
+// 获取当前线程缓存的编码转换对象, 避免每次转换都打开和关闭转换描述符
+// Convertor 编码转换类
+template <typename Convertor>
+static const Convertor & cached_cvtor(void)
 {
-	auto buffer = to_utf8_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	thread_local const Convertor cvtor;
+	return cvtor;
 }
 
 
-std::string extios::to_utf8(const std::wstring &text)
+template <typename OnputContainer, typename InputCharType, typename Convertor>
+static OnputContainer convert_to(const Convertor &cvtor, const InputCharType *s, std::size_t n, std::size_t outputsize)
 {
-	auto buffer = to_utf8_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
-}
+	using OutputCharType = typename OnputContainer::value_type;
 
+	if (n == 0)
+	{
+		return OnputContainer();
+	}
 
-std::string extios::to_utf8(const codecvtor<charset::widechar, charset::utf8> &cvtor, const std::wstring &text)
-{
-	auto buffer = to_utf8_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
-}
+	throw_if_cvtor_null(cvtor);
 
+	OnputContainer outbuf(outputsize, OutputCharType());
 
-std::vector<char> extios::to_utf8_buffer(const char16_t *s, unsigned int n)
-{
-	throw_if_string_too_long(n);
-	return ::to_mbs(s, n, CP_UTF8);
-}
+	// iconv不会修改输入数据, 可以直接转换调用者的字符串
+	auto pinbuf = const_cast<char *>(reinterpret_cast<const char *>(s));
+	auto poutbuf = reinterpret_cast<char *>(outbuf.data());
+	auto inbytes = sizeof(InputCharType) * n;
+	auto outbytes = sizeof(OutputCharType) * outbuf.size();
 
+	auto length = iconvert(cvtor.handle(), pinbuf, inbytes, poutbuf, outbytes);
+	outbuf.resize(outbuf.size() - length / sizeof(OutputCharType));
+	outbuf.shrink_to_fit();
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, unsigned int n)
-{
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::to_mbs(s, n, CP_UTF8);
+	return outbuf;
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const std::u16string &text)
+std::vector<char> extios::to_multibyte_buffer(const char *s, std::size_t n)
 {
-	throw_if_string_too_long(text.size());
-	return ::to_mbs(text.c_str(), static_cast<int>(text.size()), CP_UTF8);
+	return record_stats(charset::utf8, charset::multibyte, n, std::vector<char>(s, s + n));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const std::u16string &text)
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const char *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::to_mbs(text.c_str(), static_cast<int>(text.size()), CP_UTF8);
+	return record_stats(charset::utf8, charset::multibyte, n, std::vector<char>(s, s + n));
 }
 
 
-std::string extios::to_utf8(const char16_t *s, unsigned int n)
+std::vector<char> extios::to_multibyte_buffer(const std::string &text)
 {
-	auto buffer = to_utf8_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf8, charset::multibyte, text.size(), std::vector<char>(text.begin(), text.end()));
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, unsigned int n)
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const std::string &text)
 {
-	auto buffer = to_utf8_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::multibyte, text.size(), std::vector<char>(text.begin(), text.end()));
 }
 
 
-std::string extios::to_utf8(const std::u16string &text)
+std::string extios::to_multibyte(const char *s, std::size_t n)
 {
-	auto buffer = to_utf8_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf8, charset::multibyte, n, std::string(s, s + n));
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::utf16, charset::utf8> &cvtor, const std::u16string &text)
+std::string extios::to_multibyte(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const char *s, std::size_t n)
 {
-	auto buffer = to_utf8_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::multibyte, n, std::string(s, s + n));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const char32_t *s, unsigned int n)
+std::string extios::to_multibyte(const std::string &text)
 {
-	throw_if_string_too_long(n);
-	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n);
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_UTF8);
+	return record_stats(charset::utf8, charset::multibyte, text.size(), std::string(text.begin(), text.end()));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, unsigned int n)
+std::string extios::to_multibyte(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const std::string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	auto buffer = ::to_utf16<std::vector<char16_t>>(s, n);
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_UTF8);
+	return record_stats(charset::utf8, charset::multibyte, text.size(), std::string(text.begin(), text.end()));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const std::u32string &text)
+std::vector<char> extios::to_multibyte_buffer(const wchar_t *s, std::size_t n)
 {
-	throw_if_string_too_long(text.size());
-	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size());
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_UTF8);
+	auto &cvtor = ::cached_cvtor<codecvtor<charset::widechar, charset::multibyte>>();
+	return record_stats(charset::widechar, charset::multibyte, n, ::convert_to<std::vector<char>>(cvtor, s, n, n * 4));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const std::u32string &text)
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const wchar_t *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	auto buffer = ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size());
-	return ::to_mbs(buffer.data(), static_cast<int>(buffer.size()), CP_UTF8);
+	return record_stats(charset::widechar, charset::multibyte, n, ::utf_convert<std::vector<char>>(s, n, cvtor.policy()));
 }
 
 
-std::string extios::to_utf8(const char32_t *s, unsigned int n)
+std::vector<char> extios::to_multibyte_buffer(const std::wstring &text)
 {
-	auto buffer = to_utf8_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	auto &cvtor = ::cached_cvtor<codecvtor<charset::widechar, charset::multibyte>>();
+	return record_stats(charset::widechar, charset::multibyte, text.size(), ::convert_to<std::vector<char>>(cvtor, text.c_str(), text.size(), text.size() * 4));
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, unsigned int n)
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const std::wstring &text)
 {
-	auto buffer = to_utf8_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::multibyte, text.size(), ::utf_convert<std::vector<char>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::string extios::to_utf8(const std::u32string &text)
+std::string extios::to_multibyte(const wchar_t *s, std::size_t n)
 {
-	auto buffer = to_utf8_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
+	auto &cvtor = ::cached_cvtor<codecvtor<charset::widechar, charset::multibyte>>();
+	return record_stats(charset::widechar, charset::multibyte, n, ::convert_to<std::string>(cvtor, s, n, n * 4));
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::utf32, charset::utf8> &cvtor, const std::u32string &text)
+std::string extios::to_multibyte(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const wchar_t *s, std::size_t n)
 {
-	auto buffer = to_utf8_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::multibyte, n, ::utf_convert<std::string>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const char *s, unsigned int n, bool isutf8)
+std::string extios::to_multibyte(const std::wstring &text)
 {
-	throw_if_string_too_long(n);
-	return ::to_utf16<char16_t>(s, n, isutf8 ? CP_UTF8 : CP_ACP);
+	auto &cvtor = ::cached_cvtor<codecvtor<charset::widechar, charset::multibyte>>();
+	return record_stats(charset::widechar, charset::multibyte, text.size(), ::convert_to<std::string>(cvtor, text.c_str(), text.size(), text.size() * 4));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const char *s, unsigned int n)
+std::string extios::to_multibyte(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const std::wstring &text)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::to_utf16<char16_t>(s, n, CP_ACP);
+	return record_stats(charset::widechar, charset::multibyte, text.size(), ::utf_convert<std::string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, unsigned int n)
+std::vector<char> extios::to_multibyte_buffer(const char16_t *s, std::size_t n)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::to_utf16<char16_t>(s, n, CP_UTF8);
+	return record_stats(charset::utf16, charset::multibyte, n, ::utf_convert<std::vector<char>>(s, n));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const std::string &text, bool isutf8)
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const char16_t *s, std::size_t n)
 {
-	throw_if_string_too_long(text.size());
-	return ::to_utf16<char16_t>(text.c_str(), static_cast<int>(text.size()), isutf8 ? CP_UTF8 : CP_ACP);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::multibyte, n, ::utf_convert<std::vector<char>>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const std::string &text)
+std::vector<char> extios::to_multibyte_buffer(const std::u16string &text)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::to_utf16<char16_t>(text.c_str(), static_cast<int>(text.size()), CP_ACP);
+	return record_stats(charset::utf16, charset::multibyte, text.size(), ::utf_convert<std::vector<char>>(text.c_str(), text.size()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const std::string &text)
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const std::u16string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::to_utf16<char16_t>(text.c_str(), static_cast<int>(text.size()), CP_UTF8);
+	return record_stats(charset::utf16, charset::multibyte, text.size(), ::utf_convert<std::vector<char>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const char *s, unsigned int n, bool isutf8)
+std::string extios::to_multibyte(const char16_t *s, std::size_t n)
 {
-	auto buffer = to_utf16_buffer(s, n, isutf8);
-	return std::u16string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf16, charset::multibyte, n, ::utf_convert<std::string>(s, n));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const char *s, unsigned int n)
+std::string extios::to_multibyte(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const char16_t *s, std::size_t n)
 {
-	auto buffer = to_utf16_buffer(cvtor, s, n);
-	return std::u16string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::multibyte, n, ::utf_convert<std::string>(s, n, cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, unsigned int n)
+std::string extios::to_multibyte(const std::u16string &text)
 {
-	auto buffer = to_utf16_buffer(cvtor, s, n);
-	return std::u16string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf16, charset::multibyte, text.size(), ::utf_convert<std::string>(text.c_str(), text.size()));
 }
 
 
-std::u16string extios::to_utf16(const std::string &text, bool isutf8)
+std::string extios::to_multibyte(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const std::u16string &text)
 {
-	auto buffer = to_utf16_buffer(text, isutf8);
-	return std::u16string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::multibyte, text.size(), ::utf_convert<std::string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const std::string &text)
+std::vector<char> extios::to_multibyte_buffer(const char32_t *s, std::size_t n)
 {
-	auto buffer = to_utf16_buffer(cvtor, text);
-	return std::u16string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf32, charset::multibyte, n, ::utf_convert<std::vector<char>>(s, n));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::utf8, charset::utf16> &cvtor, const std::string &text)
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const char32_t *s, std::size_t n)
 {
-	auto buffer = to_utf16_buffer(cvtor, text);
-	return std::u16string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::multibyte, n, ::utf_convert<std::vector<char>>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const wchar_t *s, unsigned int n)
+std::vector<char> extios::to_multibyte_buffer(const std::u32string &text)
 {
-	return std::vector<char16_t>(s, s + n);
+	return record_stats(charset::utf32, charset::multibyte, text.size(), ::utf_convert<std::vector<char>>(text.c_str(), text.size()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, unsigned int n)
+std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const std::u32string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	return std::vector<char16_t>(s, s + n);
+	return record_stats(charset::utf32, charset::multibyte, text.size(), ::utf_convert<std::vector<char>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const std::wstring &text)
+std::string extios::to_multibyte(const char32_t *s, std::size_t n)
 {
-	return std::vector<char16_t>(text.begin(), text.end());
+	return record_stats(charset::utf32, charset::multibyte, n, ::utf_convert<std::string>(s, n));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const std::wstring &text)
+std::string extios::to_multibyte(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const char32_t *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	return std::vector<char16_t>(text.begin(), text.end());
+	return record_stats(charset::utf32, charset::multibyte, n, ::utf_convert<std::string>(s, n, cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const wchar_t *s, unsigned int n)
+std::string extios::to_multibyte(const std::u32string &text)
 {
-	return std::u16string(s, s + n);
+	return record_stats(charset::utf32, charset::multibyte, text.size(), ::utf_convert<std::string>(text.c_str(), text.size()));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, unsigned int n)
+std::string extios::to_multibyte(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const std::u32string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	return std::u16string(s, s + n);
+	return record_stats(charset::utf32, charset::multibyte, text.size(), ::utf_convert<std::string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const std::wstring &text)
+std::vector<wchar_t> extios::to_widechar_buffer(const char *s, std::size_t n, bool isutf8)
 {
-	return std::u16string(text.begin(), text.end());
+	if (isutf8)
+	{
+		return record_stats(charset::utf8, charset::widechar, n, ::utf_convert<std::vector<wchar_t>>(s, n));
+	}
+	auto &cvtor = ::cached_cvtor<codecvtor<charset::multibyte, charset::widechar>>();
+	return record_stats(charset::multibyte, charset::widechar, n, ::convert_to<std::vector<wchar_t>>(cvtor, s, n, n));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::widechar, charset::utf16> &cvtor, const std::wstring &text)
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const char *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	return std::u16string(text.begin(), text.end());
+	return record_stats(charset::multibyte, charset::widechar, n, ::utf_convert<std::vector<wchar_t>>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const char32_t *s, unsigned int n)
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, std::size_t n)
 {
-	return ::to_utf16<std::vector<char16_t>>(s, n);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::widechar, n, ::utf_convert<std::vector<wchar_t>>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, unsigned int n)
+std::vector<wchar_t> extios::to_widechar_buffer(const std::string &text, bool isutf8)
 {
-	throw_if_cvtor_null(cvtor);
-	return ::to_utf16<std::vector<char16_t>>(s, n);
+	if (isutf8)
+	{
+		return record_stats(charset::utf8, charset::widechar, text.size(), ::utf_convert<std::vector<wchar_t>>(text.c_str(), text.size()));
+	}
+	auto &cvtor = ::cached_cvtor<codecvtor<charset::multibyte, charset::widechar>>();
+	return record_stats(charset::multibyte, charset::widechar, text.size(), ::convert_to<std::vector<wchar_t>>(cvtor, text.c_str(), text.size(), text.size()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const std::u32string &text)
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const std::string &text)
 {
-	return ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::widechar, text.size(), ::utf_convert<std::vector<wchar_t>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const std::u32string &text)
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const std::string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	return ::to_utf16<std::vector<char16_t>>(text.c_str(), text.size());
+	return record_stats(charset::utf8, charset::widechar, text.size(), ::utf_convert<std::vector<wchar_t>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const char32_t *s, unsigned int n)
+std::wstring extios::to_widechar(const char *s, std::size_t n, bool isutf8)
 {
-	return ::to_utf16<std::u16string>(s, n);
+	if (isutf8)
+	{
+		return record_stats(charset::utf8, charset::widechar, n, ::utf_convert<std::wstring>(s, n));
+	}
+	auto &cvtor = ::cached_cvtor<codecvtor<charset::multibyte, charset::widechar>>();
+	return record_stats(charset::multibyte, charset::widechar, n, ::convert_to<std::wstring>(cvtor, s, n, n));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, unsigned int n)
+std::wstring extios::to_widechar(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const char *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	return ::to_utf16<std::u16string>(s, n);
+	return record_stats(charset::multibyte, charset::widechar, n, ::utf_convert<std::wstring>(s, n, cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const std::u32string &text)
+std::wstring extios::to_widechar(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, std::size_t n)
 {
-	return ::to_utf16<std::u16string>(text.c_str(), text.size());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::widechar, n, ::utf_convert<std::wstring>(s, n, cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::utf32, charset::utf16> &cvtor, const std::u32string &text)
+std::wstring extios::to_widechar(const std::string &text, bool isutf8)
 {
-	throw_if_cvtor_null(cvtor);
-	return ::to_utf16<std::u16string>(text.c_str(), text.size());
+	if (isutf8)
+	{
+		return record_stats(charset::utf8, charset::widechar, text.size(), ::utf_convert<std::wstring>(text.c_str(), text.size()));
+	}
+	auto &cvtor = ::cached_cvtor<codecvtor<charset::multibyte, charset::widechar>>();
+	return record_stats(charset::multibyte, charset::widechar, text.size(), ::convert_to<std::wstring>(cvtor, text.c_str(), text.size(), text.size()));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const char *s, unsigned int n, bool isutf8)
+std::wstring extios::to_widechar(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const std::string &text)
 {
-	throw_if_string_too_long(n);
-	auto buffer = ::to_utf16<char16_t>(s, n, isutf8 ? CP_UTF8 : CP_ACP);
-	return ::to_utf32<std::vector<char32_t>>(buffer.data(), buffer.size());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::widechar, text.size(), ::utf_convert<std::wstring>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const char *s, unsigned int n)
+std::wstring extios::to_widechar(const codecvtor<charset::utf8, charset::widechar> &cvtor, const std::string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	auto buffer = ::to_utf16<char16_t>(s, n, CP_ACP);
-	return ::to_utf32<std::vector<char32_t>>(buffer.data(), buffer.size());
+	return record_stats(charset::utf8, charset::widechar, text.size(), ::utf_convert<std::wstring>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, unsigned int n)
+std::vector<wchar_t> extios::to_widechar_buffer(const char16_t *s, std::size_t n)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	auto buffer = ::to_utf16<char16_t>(s, n, CP_UTF8);
-	return ::to_utf32<std::vector<char32_t>>(buffer.data(), buffer.size());
+	return record_stats(charset::utf16, charset::widechar, n, ::utf_convert<std::vector<wchar_t>>(s, n));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const std::string &text, bool isutf8)
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, std::size_t n)
 {
-	throw_if_string_too_long(text.size());
-	auto buffer = ::to_utf16<char16_t>(text.c_str(), static_cast<int>(text.size()), isutf8 ? CP_UTF8 : CP_ACP);
-	return ::to_utf32<std::vector<char32_t>>(buffer.data(), buffer.size());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::widechar, n, ::utf_convert<std::vector<wchar_t>>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const std::string &text)
+std::vector<wchar_t> extios::to_widechar_buffer(const std::u16string &text)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	auto buffer = ::to_utf16<char16_t>(text.c_str(), static_cast<int>(text.size()), CP_ACP);
-	return ::to_utf32<std::vector<char32_t>>(buffer.data(), buffer.size());
+	return record_stats(charset::utf16, charset::widechar, text.size(), ::utf_convert<std::vector<wchar_t>>(text.c_str(), text.size()));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const std::string &text)
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const std::u16string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	auto buffer = ::to_utf16<char16_t>(text.c_str(), static_cast<int>(text.size()), CP_UTF8);
-	return ::to_utf32<std::vector<char32_t>>(buffer.data(), buffer.size());
+	return record_stats(charset::utf16, charset::widechar, text.size(), ::utf_convert<std::vector<wchar_t>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::u32string extios::to_utf32(const char *s, unsigned int n, bool isutf8)
+std::wstring extios::to_widechar(const char16_t *s, std::size_t n)
 {
-	auto buffer = to_utf32_buffer(s, n, isutf8);
-	return std::u32string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf16, charset::widechar, n, ::utf_convert<std::wstring>(s, n));
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const char *s, unsigned int n)
+std::wstring extios::to_widechar(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, std::size_t n)
 {
-	auto buffer = to_utf32_buffer(cvtor, s, n);
-	return std::u32string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::widechar, n, ::utf_convert<std::wstring>(s, n, cvtor.policy()));
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, unsigned int n)
+std::wstring extios::to_widechar(const std::u16string &text)
 {
-	auto buffer = to_utf32_buffer(cvtor, s, n);
-	return std::u32string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf16, charset::widechar, text.size(), ::utf_convert<std::wstring>(text.c_str(), text.size()));
 }
 
 
-std::u32string extios::to_utf32(const std::string &text, bool isutf8)
+std::wstring extios::to_widechar(const codecvtor<charset::utf16, charset::widechar> &cvtor, const std::u16string &text)
 {
-	auto buffer = to_utf32_buffer(text, isutf8);
-	return std::u32string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::widechar, text.size(), ::utf_convert<std::wstring>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const std::string &text)
+std::vector<wchar_t> extios::to_widechar_buffer(const char32_t *s, std::size_t n)
 {
-	auto buffer = to_utf32_buffer(cvtor, text);
-	return std::u32string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf32, charset::widechar, n, std::vector<wchar_t>(s, s + n));
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::utf8, charset::utf32> &cvtor, const std::string &text)
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, std::size_t n)
 {
-	auto buffer = to_utf32_buffer(cvtor, text);
-	return std::u32string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::widechar, n, std::vector<wchar_t>(s, s + n));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const wchar_t *s, unsigned int n)
+std::vector<wchar_t> extios::to_widechar_buffer(const std::u32string &text)
 {
-	return ::to_utf32<std::vector<char32_t>>(s, n);
+	return record_stats(charset::utf32, charset::widechar, text.size(), std::vector<wchar_t>(text.begin(), text.end()));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, unsigned int n)
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const std::u32string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	return ::to_utf32<std::vector<char32_t>>(s, n);
+	return record_stats(charset::utf32, charset::widechar, text.size(), std::vector<wchar_t>(text.begin(), text.end()));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const std::wstring &text)
+std::wstring extios::to_widechar(const char32_t *s, std::size_t n)
 {
-	return ::to_utf32<std::vector<char32_t>>(text.c_str(), text.size());
+	return record_stats(charset::utf32, charset::widechar, n, std::wstring(s, s + n));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const std::wstring &text)
+std::wstring extios::to_widechar(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	return ::to_utf32<std::vector<char32_t>>(text.c_str(), text.size());
+	return record_stats(charset::utf32, charset::widechar, n, std::wstring(s, s + n));
 }
 
 
-std::u32string extios::to_utf32(const wchar_t *s, unsigned int n)
+std::wstring extios::to_widechar(const std::u32string &text)
 {
-	return ::to_utf32<std::u32string>(s, n);
+	return record_stats(charset::utf32, charset::widechar, text.size(), std::wstring(text.begin(), text.end()));
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, unsigned int n)
+std::wstring extios::to_widechar(const codecvtor<charset::utf32, charset::widechar> &cvtor, const std::u32string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	return ::to_utf32<std::u32string>(s, n);
+	return record_stats(charset::utf32, charset::widechar, text.size(), std::wstring(text.begin(), text.end()));
 }
 
 
-std::u32string extios::to_utf32(const std::wstring &text)
+std::vector<char> extios::to_utf8_buffer(const char *s, std::size_t n)
 {
-	return ::to_utf32<std::u32string>(text.c_str(), text.size());
+	return record_stats(charset::multibyte, charset::utf8, n, std::vector<char>(s, s + n));
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::widechar, charset::utf32> &cvtor, const std::wstring &text)
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const char *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	return ::to_utf32<std::u32string>(text.c_str(), text.size());
+	return record_stats(charset::multibyte, charset::utf8, n, std::vector<char>(s, s + n));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const char16_t *s, unsigned int n)
+std::vector<char> extios::to_utf8_buffer(const std::string &text)
 {
-	return ::to_utf32<std::vector<char32_t>>(s, n);
+	return record_stats(charset::multibyte, charset::utf8, text.size(), std::vector<char>(text.begin(), text.end()));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, unsigned int n)
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const std::string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	return ::to_utf32<std::vector<char32_t>>(s, n);
+	return record_stats(charset::multibyte, charset::utf8, text.size(), std::vector<char>(text.begin(), text.end()));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const std::u16string &text)
+std::string extios::to_utf8(const char *s, std::size_t n)
 {
-	return ::to_utf32<std::vector<char32_t>>(text.c_str(), text.size());
+	return record_stats(charset::multibyte, charset::utf8, n, std::string(s, s + n));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const std::u16string &text)
+std::string extios::to_utf8(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const char *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	return ::to_utf32<std::vector<char32_t>>(text.c_str(), text.size());
+	return record_stats(charset::multibyte, charset::utf8, n, std::string(s, s + n));
 }
 
 
-std::u32string extios::to_utf32(const char16_t *s, unsigned int n)
+std::string extios::to_utf8(const std::string &text)
 {
-	return ::to_utf32<std::u32string>(s, n);
+	return record_stats(charset::multibyte, charset::utf8, text.size(), std::string(text.begin(), text.end()));
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, unsigned int n)
+std::string extios::to_utf8(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const std::string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	return ::to_utf32<std::u32string>(s, n);
+	return record_stats(charset::multibyte, charset::utf8, text.size(), std::string(text.begin(), text.end()));
 }
 
 
-std::u32string extios::to_utf32(const std::u16string &text)
+std::vector<char> extios::to_utf8_buffer(const wchar_t *s, std::size_t n)
 {
-	return ::to_utf32<std::u32string>(text.c_str(), text.size());
+	return record_stats(charset::widechar, charset::utf8, n, ::utf_convert<std::vector<char>>(s, n));
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::utf16, charset::utf32> &cvtor, const std::u16string &text)
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	return ::to_utf32<std::u32string>(text.c_str(), text.size());
+	return record_stats(charset::widechar, charset::utf8, n, ::utf_convert<std::vector<char>>(s, n, cvtor.policy()));
 }
 
 
-#else // !_MSC_VER
+std::vector<char> extios::to_utf8_buffer(const std::wstring &text)
+{
+	return record_stats(charset::widechar, charset::utf8, text.size(), ::utf_convert<std::vector<char>>(text.c_str(), text.size()));
+}
 
-#include <iconv.h> // iconv_open iconv iconv_close
-#include <cstring> // std::strerror
-#include <cerrno> // cerrno
 
-struct extios::codecvtor_base::member_data
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const std::wstring &text)
 {
-	iconv_t cd;
-
-	member_data(const char *fromcode, const char *tocode);
-	~member_data(void);
-	member_data(const member_data &) = delete;
-	member_data(member_data &&) = delete;
-	member_data & operator=(const member_data &) = delete;
-	member_data & operator=(member_data &&) = delete;
-};
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf8, text.size(), ::utf_convert<std::vector<char>>(text.c_str(), text.size(), cvtor.policy()));
+}
 
 
-extios::codecvtor_base::member_data::member_data(const char *fromcode, const char *tocode)
-	: cd(::iconv_open(tocode, fromcode))
+std::string extios::to_utf8(const wchar_t *s, std::size_t n)
 {
-	if (cd == reinterpret_cast<iconv_t>(-1))
-	{
-		throw std::invalid_argument(std::strerror(errno));
-	}
+	return record_stats(charset::widechar, charset::utf8, n, ::utf_convert<std::string>(s, n));
 }
 
 
-extios::codecvtor_base::member_data::~member_data(void)
+std::string extios::to_utf8(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, std::size_t n)
 {
-	if (cd != reinterpret_cast<iconv_t>(-1))
-	{
-		::iconv_close(cd);
-	}
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf8, n, ::utf_convert<std::string>(s, n, cvtor.policy()));
 }
 
 
-void * extios::codecvtor_base::handle(void) const noexcept
+std::string extios::to_utf8(const std::wstring &text)
 {
-	return m_data->cd;
+	return record_stats(charset::widechar, charset::utf8, text.size(), ::utf_convert<std::string>(text.c_str(), text.size()));
 }
 
 
-extios::codecvtor<extios::charset::multibyte, extios::charset::widechar>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-8", "UTF-32"))
+std::string extios::to_utf8(const codecvtor<charset::widechar, charset::utf8> &cvtor, const std::wstring &text)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf8, text.size(), ::utf_convert<std::string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::multibyte, extios::charset::utf8>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-8", "UTF-8"))
+std::vector<char> extios::to_utf8_buffer(const char16_t *s, std::size_t n)
 {
+	return record_stats(charset::utf16, charset::utf8, n, ::utf_convert<std::vector<char>>(s, n));
 }
 
 
-extios::codecvtor<extios::charset::multibyte, extios::charset::utf16>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-8", "UTF-16"))
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, std::size_t n)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf8, n, ::utf_convert<std::vector<char>>(s, n, cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::multibyte, extios::charset::utf32>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-8", "UTF-32"))
+std::vector<char> extios::to_utf8_buffer(const std::u16string &text)
 {
+	return record_stats(charset::utf16, charset::utf8, text.size(), ::utf_convert<std::vector<char>>(text.c_str(), text.size()));
 }
 
 
-extios::codecvtor<extios::charset::widechar, extios::charset::multibyte>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-32", "UTF-8"))
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const std::u16string &text)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf8, text.size(), ::utf_convert<std::vector<char>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::widechar, extios::charset::utf8>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-32", "UTF-8"))
+std::string extios::to_utf8(const char16_t *s, std::size_t n)
 {
+	return record_stats(charset::utf16, charset::utf8, n, ::utf_convert<std::string>(s, n));
 }
 
 
-extios::codecvtor<extios::charset::widechar, extios::charset::utf16>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-32", "UTF-16"))
+std::string extios::to_utf8(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, std::size_t n)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf8, n, ::utf_convert<std::string>(s, n, cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::widechar, extios::charset::utf32>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-32", "UTF-32"))
+std::string extios::to_utf8(const std::u16string &text)
 {
+	return record_stats(charset::utf16, charset::utf8, text.size(), ::utf_convert<std::string>(text.c_str(), text.size()));
 }
 
 
-extios::codecvtor<extios::charset::utf8, extios::charset::multibyte>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-8", "UTF-8"))
+std::string extios::to_utf8(const codecvtor<charset::utf16, charset::utf8> &cvtor, const std::u16string &text)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf8, text.size(), ::utf_convert<std::string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::utf8, extios::charset::widechar>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-8", "UTF-32"))
+std::vector<char> extios::to_utf8_buffer(const char32_t *s, std::size_t n)
 {
+	return record_stats(charset::utf32, charset::utf8, n, ::utf_convert<std::vector<char>>(s, n));
 }
 
 
-extios::codecvtor<extios::charset::utf8, extios::charset::utf16>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-8", "UTF-16"))
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, std::size_t n)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::utf8, n, ::utf_convert<std::vector<char>>(s, n, cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::utf8, extios::charset::utf32>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-8", "UTF-32"))
+std::vector<char> extios::to_utf8_buffer(const std::u32string &text)
 {
+	return record_stats(charset::utf32, charset::utf8, text.size(), ::utf_convert<std::vector<char>>(text.c_str(), text.size()));
 }
 
 
-extios::codecvtor<extios::charset::utf16, extios::charset::multibyte>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-16", "UTF-8"))
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const std::u32string &text)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::utf8, text.size(), ::utf_convert<std::vector<char>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::utf16, extios::charset::widechar>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-16", "UTF-32"))
+std::string extios::to_utf8(const char32_t *s, std::size_t n)
 {
+	return record_stats(charset::utf32, charset::utf8, n, ::utf_convert<std::string>(s, n));
 }
 
 
-extios::codecvtor<extios::charset::utf16, extios::charset::utf8>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-16", "UTF-8"))
+std::string extios::to_utf8(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, std::size_t n)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::utf8, n, ::utf_convert<std::string>(s, n, cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::utf16, extios::charset::utf32>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-16", "UTF-32"))
+std::string extios::to_utf8(const std::u32string &text)
 {
+	return record_stats(charset::utf32, charset::utf8, text.size(), ::utf_convert<std::string>(text.c_str(), text.size()));
 }
 
 
-extios::codecvtor<extios::charset::utf32, extios::charset::multibyte>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-32", "UTF-8"))
+std::string extios::to_utf8(const codecvtor<charset::utf32, charset::utf8> &cvtor, const std::u32string &text)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::utf8, text.size(), ::utf_convert<std::string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::utf32, extios::charset::widechar>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-32", "UTF-32"))
+std::vector<char16_t> extios::to_utf16_buffer(const char *s, std::size_t n, bool isutf8)
 {
+	if (isutf8)
+	{
+		return record_stats(charset::utf8, charset::utf16, n, ::utf_convert<std::vector<char16_t>>(s, n));
+	}
+	auto &cvtor = ::cached_cvtor<codecvtor<charset::multibyte, charset::utf16>>();
+	return record_stats(charset::multibyte, charset::utf16, n, ::convert_to<std::vector<char16_t>>(cvtor, s, n, n * 2));
 }
 
 
-extios::codecvtor<extios::charset::utf32, extios::charset::utf8>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-32", "UTF-8"))
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const char *s, std::size_t n)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::utf16, n, ::utf_convert<std::vector<char16_t>>(s, n, cvtor.policy()));
 }
 
 
-extios::codecvtor<extios::charset::utf32, extios::charset::utf16>::codecvtor(void)
-	: codecvtor_base(std::make_shared<member_data>("UTF-32", "UTF-16"))
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, std::size_t n)
 {
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf16, n, ::utf_convert<std::vector<char16_t>>(s, n, cvtor.policy()));
 }
 
 
-static std::size_t iconvert(iconv_t cd, char *inbuf, std::size_t inbytes, char *outbuf, std::size_t outbytes)
+std::vector<char16_t> extios::to_utf16_buffer(const std::string &text, bool isutf8)
 {
-	if (::iconv(cd, &inbuf, &inbytes, &outbuf, &outbytes) == static_cast<std::size_t>(-1))
+	if (isutf8)
 	{
-		throw std::invalid_argument(std::strerror(errno));
+		return record_stats(charset::utf8, charset::utf16, text.size(), ::utf_convert<std::vector<char16_t>>(text.c_str(), text.size()));
 	}
-	return outbytes;
+	auto &cvtor = ::cached_cvtor<codecvtor<charset::multibyte, charset::utf16>>();
+	return record_stats(charset::multibyte, charset::utf16, text.size(), ::convert_to<std::vector<char16_t>>(cvtor, text.c_str(), text.size(), text.size() * 2));
 }
 
 
-template <typename OutputCharType, typename InputCharType, typename Convertor>
-static std::vector<OutputCharType> convert_to(const Convertor &cvtor, const InputCharType *s, std::size_t n, std::size_t outputsize)
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const std::string &text)
 {
-	using input_buffer_type = typename std::vector<InputCharType>;
-	using output_buffer_type = typename std::vector<OutputCharType>;
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::utf16, text.size(), ::utf_convert<std::vector<char16_t>>(text.c_str(), text.size(), cvtor.policy()));
+}
 
-	if (n == 0)
-	{
-		return output_buffer_type();
-	}
 
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const std::string &text)
+{
 	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf16, text.size(), ::utf_convert<std::vector<char16_t>>(text.c_str(), text.size(), cvtor.policy()));
+}
 
-	input_buffer_type inbuf(s, s + n);
-	output_buffer_type outbuf(outputsize + 1);
-
-	auto pinbuf = reinterpret_cast<char *>(inbuf.data());
-	auto poutbuf = reinterpret_cast<char *>(outbuf.data());
-	auto inbytes = sizeof(InputCharType) * inbuf.size();
-	auto outbytes = sizeof(OutputCharType) * outbuf.size();
 
-	auto length = iconvert(cvtor.handle(), pinbuf, inbytes, poutbuf, outbytes);
-	if constexpr (std::is_same<OutputCharType, char16_t>::value || std::is_same<OutputCharType, char32_t>::value)
+std::u16string extios::to_utf16(const char *s, std::size_t n, bool isutf8)
+{
+	if (isutf8)
 	{
-		outbuf.erase(outbuf.begin());
+		return record_stats(charset::utf8, charset::utf16, n, ::utf_convert<std::u16string>(s, n));
 	}
-	outbuf.resize(outbuf.size() - length / sizeof(OutputCharType));
-	outbuf.shrink_to_fit();
-
-	return outbuf;
+	auto &cvtor = ::cached_cvtor<codecvtor<charset::multibyte, charset::utf16>>();
+	return record_stats(charset::multibyte, charset::utf16, n, ::convert_to<std::u16string>(cvtor, s, n, n * 2));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const char *s, unsigned int n)
+std::u16string extios::to_utf16(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const char *s, std::size_t n)
 {
-	throw_if_string_too_long(n);
-	return std::vector<char>(s, s + n);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::utf16, n, ::utf_convert<std::u16string>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const char *s, unsigned int n)
+std::u16string extios::to_utf16(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, std::size_t n)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return std::vector<char>(s, s + n);
+	return record_stats(charset::utf8, charset::utf16, n, ::utf_convert<std::u16string>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const std::string &text)
+std::u16string extios::to_utf16(const std::string &text, bool isutf8)
 {
-	throw_if_string_too_long(text.size());
-	return std::vector<char>(text.begin(), text.end());
+	if (isutf8)
+	{
+		return record_stats(charset::utf8, charset::utf16, text.size(), ::utf_convert<std::u16string>(text.c_str(), text.size()));
+	}
+	auto &cvtor = ::cached_cvtor<codecvtor<charset::multibyte, charset::utf16>>();
+	return record_stats(charset::multibyte, charset::utf16, text.size(), ::convert_to<std::u16string>(cvtor, text.c_str(), text.size(), text.size() * 2));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const std::string &text)
+std::u16string extios::to_utf16(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const std::string &text)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return std::vector<char>(text.begin(), text.end());
+	return record_stats(charset::multibyte, charset::utf16, text.size(), ::utf_convert<std::u16string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const char *s, unsigned int n)
+std::u16string extios::to_utf16(const codecvtor<charset::utf8, charset::utf16> &cvtor, const std::string &text)
 {
-	throw_if_string_too_long(n);
-	return std::string(s, s + n);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf16, text.size(), ::utf_convert<std::u16string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const char *s, unsigned int n)
+std::vector<char16_t> extios::to_utf16_buffer(const wchar_t *s, std::size_t n)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return std::string(s, s + n);
+	return record_stats(charset::widechar, charset::utf16, n, ::utf_convert<std::vector<char16_t>>(s, n));
 }
 
 
-std::string extios::to_multibyte(const std::string &text)
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, std::size_t n)
 {
-	throw_if_string_too_long(text.size());
-	return std::string(text.begin(), text.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf16, n, ::utf_convert<std::vector<char16_t>>(s, n, cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const std::string &text)
+std::vector<char16_t> extios::to_utf16_buffer(const std::wstring &text)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return std::string(text.begin(), text.end());
+	return record_stats(charset::widechar, charset::utf16, text.size(), ::utf_convert<std::vector<char16_t>>(text.c_str(), text.size()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const wchar_t *s, unsigned int n)
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const std::wstring &text)
 {
-	throw_if_string_too_long(n);
-	codecvtor<charset::widechar, charset::multibyte> cvtor;
-	return ::convert_to<char>(cvtor, s, n, n * 4);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf16, text.size(), ::utf_convert<std::vector<char16_t>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const wchar_t *s, unsigned int n)
+std::u16string extios::to_utf16(const wchar_t *s, std::size_t n)
 {
-	throw_if_string_too_long(n);
-	return ::convert_to<char>(cvtor, s, n, n * 4);
+	return record_stats(charset::widechar, charset::utf16, n, ::utf_convert<std::u16string>(s, n));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const std::wstring &text)
+std::u16string extios::to_utf16(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, std::size_t n)
 {
-	throw_if_string_too_long(text.size());
-	codecvtor<charset::widechar, charset::multibyte> cvtor;
-	return ::convert_to<char>(cvtor, text.c_str(), text.size(), text.size() * 4);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf16, n, ::utf_convert<std::u16string>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const std::wstring &text)
+std::u16string extios::to_utf16(const std::wstring &text)
 {
-	throw_if_string_too_long(text.size());
-	return ::convert_to<char>(cvtor, text.c_str(), text.size(), text.size() * 4);
+	return record_stats(charset::widechar, charset::utf16, text.size(), ::utf_convert<std::u16string>(text.c_str(), text.size()));
 }
 
 
-std::string extios::to_multibyte(const wchar_t *s, unsigned int n)
+std::u16string extios::to_utf16(const codecvtor<charset::widechar, charset::utf16> &cvtor, const std::wstring &text)
 {
-	auto buffer = to_multibyte_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf16, text.size(), ::utf_convert<std::u16string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const wchar_t *s, unsigned int n)
+std::vector<char16_t> extios::to_utf16_buffer(const char32_t *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf32, charset::utf16, n, ::utf_convert<std::vector<char16_t>>(s, n));
 }
 
 
-std::string extios::to_multibyte(const std::wstring &text)
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::utf16, n, ::utf_convert<std::vector<char16_t>>(s, n, cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const std::wstring &text)
+std::vector<char16_t> extios::to_utf16_buffer(const std::u32string &text)
 {
-	auto buffer = to_multibyte_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf32, charset::utf16, text.size(), ::utf_convert<std::vector<char16_t>>(text.c_str(), text.size()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const char16_t *s, unsigned int n)
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const std::u32string &text)
 {
-	throw_if_string_too_long(n);
-	codecvtor<charset::utf16, charset::multibyte> cvtor;
-	return ::convert_to<char>(cvtor, s, n, n * 4);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::utf16, text.size(), ::utf_convert<std::vector<char16_t>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const char16_t *s, unsigned int n)
+std::u16string extios::to_utf16(const char32_t *s, std::size_t n)
 {
-	throw_if_string_too_long(n);
-	return ::convert_to<char>(cvtor, s, n, n * 4);
+	return record_stats(charset::utf32, charset::utf16, n, ::utf_convert<std::u16string>(s, n));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const std::u16string &text)
+std::u16string extios::to_utf16(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, std::size_t n)
 {
-	throw_if_string_too_long(text.size());
-	codecvtor<charset::utf16, charset::multibyte> cvtor;
-	return ::convert_to<char>(cvtor, text.c_str(), text.size(), text.size() * 4);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::utf16, n, ::utf_convert<std::u16string>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const std::u16string &text)
+std::u16string extios::to_utf16(const std::u32string &text)
 {
-	throw_if_string_too_long(text.size());
-	return ::convert_to<char>(cvtor, text.c_str(), text.size(), text.size() * 4);
+	return record_stats(charset::utf32, charset::utf16, text.size(), ::utf_convert<std::u16string>(text.c_str(), text.size()));
 }
 
 
-std::string extios::to_multibyte(const char16_t *s, unsigned int n)
+std::u16string extios::to_utf16(const codecvtor<charset::utf32, charset::utf16> &cvtor, const std::u32string &text)
 {
-	auto buffer = to_multibyte_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::utf16, text.size(), ::utf_convert<std::u16string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const char16_t *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const char *s, std::size_t n, bool)
 {
-	auto buffer = to_multibyte_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf8, charset::utf32, n, ::utf_convert<std::vector<char32_t>>(s, n));
 }
 
 
-std::string extios::to_multibyte(const std::u16string &text)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const char *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::utf32, n, ::utf_convert<std::vector<char32_t>>(s, n, cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const std::u16string &text)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf32, n, ::utf_convert<std::vector<char32_t>>(s, n, cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const char32_t *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const std::string &text, bool)
 {
-	throw_if_string_too_long(n);
-	codecvtor<charset::utf32, charset::multibyte> cvtor;
-	return ::convert_to<char>(cvtor, s, n, n * 4);
+	return record_stats(charset::utf8, charset::utf32, text.size(), ::utf_convert<std::vector<char32_t>>(text.c_str(), text.size()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const char32_t *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const std::string &text)
 {
-	throw_if_string_too_long(n);
-	return ::convert_to<char>(cvtor, s, n, n * 4);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::utf32, text.size(), ::utf_convert<std::vector<char32_t>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const std::u32string &text)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const std::string &text)
 {
-	throw_if_string_too_long(text.size());
-	codecvtor<charset::utf32, charset::multibyte> cvtor;
-	return ::convert_to<char>(cvtor, text.c_str(), text.size(), text.size() * 4);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf32, text.size(), ::utf_convert<std::vector<char32_t>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_multibyte_buffer(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const std::u32string &text)
+std::u32string extios::to_utf32(const char *s, std::size_t n, bool)
 {
-	throw_if_string_too_long(text.size());
-	return ::convert_to<char>(cvtor, text.c_str(), text.size(), text.size() * 4);
+	return record_stats(charset::utf8, charset::utf32, n, ::utf_convert<std::u32string>(s, n));
 }
 
 
-std::string extios::to_multibyte(const char32_t *s, unsigned int n)
+std::u32string extios::to_utf32(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const char *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::utf32, n, ::utf_convert<std::u32string>(s, n, cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const char32_t *s, unsigned int n)
+std::u32string extios::to_utf32(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, std::size_t n)
 {
-	auto buffer = to_multibyte_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf32, n, ::utf_convert<std::u32string>(s, n, cvtor.policy()));
 }
 
 
-std::string extios::to_multibyte(const std::u32string &text)
+std::u32string extios::to_utf32(const std::string &text, bool)
 {
-	auto buffer = to_multibyte_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf8, charset::utf32, text.size(), ::utf_convert<std::u32string>(text.c_str(), text.size()));
 }
 
 
-std::string extios::to_multibyte(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const std::u32string &text)
+std::u32string extios::to_utf32(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const std::string &text)
 {
-	auto buffer = to_multibyte_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::multibyte, charset::utf32, text.size(), ::utf_convert<std::u32string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const char *s, unsigned int n, bool)
+std::u32string extios::to_utf32(const codecvtor<charset::utf8, charset::utf32> &cvtor, const std::string &text)
 {
-	throw_if_string_too_long(n);
-	codecvtor<charset::multibyte, charset::widechar> cvtor;
-	return ::convert_to<wchar_t>(cvtor, s, n, n);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf32, text.size(), ::utf_convert<std::u32string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const char *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const wchar_t *s, std::size_t n)
 {
-	throw_if_string_too_long(n);
-	return ::convert_to<wchar_t>(cvtor, s, n, n);
+	return record_stats(charset::widechar, charset::utf32, n, std::vector<char32_t>(s, s + n));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, std::size_t n)
 {
-	throw_if_string_too_long(n);
-	return ::convert_to<wchar_t>(cvtor, s, n, n);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf32, n, std::vector<char32_t>(s, s + n));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const std::string &text, bool)
+std::vector<char32_t> extios::to_utf32_buffer(const std::wstring &text)
 {
-	throw_if_string_too_long(text.size());
-	codecvtor<charset::multibyte, charset::widechar> cvtor;
-	return ::convert_to<wchar_t>(cvtor, text.c_str(), text.size(), text.size());
+	return record_stats(charset::widechar, charset::utf32, text.size(), std::vector<char32_t>(text.begin(), text.end()));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const std::string &text)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const std::wstring &text)
 {
-	throw_if_string_too_long(text.size());
-	return ::convert_to<wchar_t>(cvtor, text.c_str(), text.size(), text.size());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf32, text.size(), std::vector<char32_t>(text.begin(), text.end()));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const std::string &text)
+std::u32string extios::to_utf32(const wchar_t *s, std::size_t n)
 {
-	throw_if_string_too_long(text.size());
-	return ::convert_to<wchar_t>(cvtor, text.c_str(), text.size(), text.size());
+	return record_stats(charset::widechar, charset::utf32, n, std::u32string(s, s + n));
 }
 
 
-std::wstring extios::to_widechar(const char *s, unsigned int n, bool isutf8)
+std::u32string extios::to_utf32(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, std::size_t n)
 {
-	auto buffer = to_widechar_buffer(s, n, isutf8);
-	return std::wstring(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf32, n, std::u32string(s, s + n));
 }
 
 
-std::wstring extios::to_widechar(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const char *s, unsigned int n)
+std::u32string extios::to_utf32(const std::wstring &text)
 {
-	auto buffer = to_widechar_buffer(cvtor, s, n);
-	return std::wstring(buffer.begin(), buffer.end());
+	return record_stats(charset::widechar, charset::utf32, text.size(), std::u32string(text.begin(), text.end()));
 }
 
 
-std::wstring extios::to_widechar(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, unsigned int n)
+std::u32string extios::to_utf32(const codecvtor<charset::widechar, charset::utf32> &cvtor, const std::wstring &text)
 {
-	auto buffer = to_widechar_buffer(cvtor, s, n);
-	return std::wstring(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf32, text.size(), std::u32string(text.begin(), text.end()));
 }
 
 
-std::wstring extios::to_widechar(const std::string &text, bool isutf8)
+std::vector<char32_t> extios::to_utf32_buffer(const char16_t *s, std::size_t n)
 {
-	auto buffer = to_widechar_buffer(text, isutf8);
-	return std::wstring(buffer.begin(), buffer.end());
+	return record_stats(charset::utf16, charset::utf32, n, ::utf_convert<std::vector<char32_t>>(s, n));
 }
 
 
-std::wstring extios::to_widechar(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const std::string &text)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, std::size_t n)
 {
-	auto buffer = to_widechar_buffer(cvtor, text);
-	return std::wstring(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf32, n, ::utf_convert<std::vector<char32_t>>(s, n, cvtor.policy()));
 }
 
 
-std::wstring extios::to_widechar(const codecvtor<charset::utf8, charset::widechar> &cvtor, const std::string &text)
+std::vector<char32_t> extios::to_utf32_buffer(const std::u16string &text)
 {
-	auto buffer = to_widechar_buffer(cvtor, text);
-	return std::wstring(buffer.begin(), buffer.end());
+	return record_stats(charset::utf16, charset::utf32, text.size(), ::utf_convert<std::vector<char32_t>>(text.c_str(), text.size()));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const char16_t *s, unsigned int n)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const std::u16string &text)
 {
-	codecvtor<charset::utf16, charset::widechar> cvtor;
-	return ::convert_to<wchar_t>(cvtor, s, n, n);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf32, text.size(), ::utf_convert<std::vector<char32_t>>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, unsigned int n)
+std::u32string extios::to_utf32(const char16_t *s, std::size_t n)
 {
-	return ::convert_to<wchar_t>(cvtor, s, n, n);
+	return record_stats(charset::utf16, charset::utf32, n, ::utf_convert<std::u32string>(s, n));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const std::u16string &text)
+std::u32string extios::to_utf32(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, std::size_t n)
 {
-	codecvtor<charset::utf16, charset::widechar> cvtor;
-	return ::convert_to<wchar_t>(cvtor, text.c_str(), text.size(), text.size());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf32, n, ::utf_convert<std::u32string>(s, n, cvtor.policy()));
 }
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const std::u16string &text)
+std::u32string extios::to_utf32(const std::u16string &text)
 {
-	return ::convert_to<wchar_t>(cvtor, text.c_str(), text.size(), text.size());
+	return record_stats(charset::utf16, charset::utf32, text.size(), ::utf_convert<std::u32string>(text.c_str(), text.size()));
 }
 
 
-std::wstring extios::to_widechar(const char16_t *s, unsigned int n)
+std::u32string extios::to_utf32(const codecvtor<charset::utf16, charset::utf32> &cvtor, const std::u16string &text)
 {
-	auto buffer = to_widechar_buffer(s, n);
-	return std::wstring(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf32, text.size(), ::utf_convert<std::u32string>(text.c_str(), text.size(), cvtor.policy()));
 }
 
 
-std::wstring extios::to_widechar(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, unsigned int n)
+// 抛出文件操作失败的异常
+// error 错误码
+// what 失败的操作
+[[noreturn]] static void throw_file_error(int error, const char *what)
 {
-	auto buffer = to_widechar_buffer(cvtor, s, n);
-	return std::wstring(buffer.begin(), buffer.end());
+	throw std::system_error(error, std::generic_category(), what);
 }
 
 
-std::wstring extios::to_widechar(const std::u16string &text)
+// 只读映射到内存的输入文件, 不能映射的文件(如管道)整体读入内存
+struct mapped_file
 {
-	auto buffer = to_widechar_buffer(text);
-	return std::wstring(buffer.begin(), buffer.end());
-}
+	// path 文件路径
+	explicit mapped_file(const char *path)
+		: data(nullptr)
+		, size(0)
+		, mapped(false)
+	{
+		int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			::throw_file_error(errno, "打开输入文件失败");
+		}
+
+		struct stat status;
+		if (::fstat(fd, &status) != 0)
+		{
+			int error = errno;
+			::close(fd);
+			::throw_file_error(error, "获取输入文件信息失败");
+		}
+		device = status.st_dev;
+		inode = status.st_ino;
+
+		if (S_ISREG(status.st_mode))
+		{
+			size = static_cast<std::size_t>(status.st_size);
+			if (size != 0)
+			{
+				void *address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (address == MAP_FAILED)
+				{
+					int error = errno;
+					::close(fd);
+					::throw_file_error(error, "映射输入文件失败");
+				}
+				::madvise(address, size, MADV_SEQUENTIAL);
+				data = static_cast<const char *>(address);
+				mapped = true;
+			}
+		}
+		else
+		{
+			for (;;)
+			{
+				if (buffer.size() - size < ::file_read_size)
+				{
+					buffer.resize(size + ::file_read_size);
+				}
+				ssize_t length = ::read(fd, buffer.data() + size, buffer.size() - size);
+				if (length == 0)
+				{
+					break;
+				}
+				if (length < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+					int error = errno;
+					::close(fd);
+					::throw_file_error(error, "读取输入文件失败");
+				}
+				size += static_cast<std::size_t>(length);
+			}
+			data = buffer.data();
+		}
 
+		// 映射之后关闭文件不影响已映射的内容
+		::close(fd);
+	}
 
-std::wstring extios::to_widechar(const codecvtor<charset::utf16, charset::widechar> &cvtor, const std::u16string &text)
-{
-	auto buffer = to_widechar_buffer(cvtor, text);
-	return std::wstring(buffer.begin(), buffer.end());
-}
+	mapped_file(const mapped_file &) = delete;
+	mapped_file & operator=(const mapped_file &) = delete;
 
+	~mapped_file(void)
+	{
+		if (mapped)
+		{
+			::munmap(const_cast<char *>(data), size);
+		}
+	}
 
-std::vector<wchar_t> extios::to_widechar_buffer(const char32_t *s, unsigned int n)
-{
-	return std::vector<wchar_t>(s, s + n);
-}
+	const char *data; // 文件内容的首地址
+	std::size_t size; // 文件的字节数
+	bool mapped; // 是否映射到内存
+	std::vector<char> buffer; // 不能映射时读入的文件内容
+	dev_t device; // 文件所在的设备
+	ino_t inode; // 文件的索引节点
+};
 
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, unsigned int n)
+// 转换结果的输出文件
+struct output_file
 {
-	throw_if_cvtor_null(cvtor);
-	return std::vector<wchar_t>(s, s + n);
-}
+	// path 文件路径, 已存在时清空原有内容
+	// input 输入文件, 输出文件和输入文件相同时抛出异常, 避免清空正在读取的映射
+	output_file(const char *path, const mapped_file &input)
+		: fd(::open(path, O_WRONLY | O_CREAT | O_CLOEXEC, 0666))
+	{
+		if (fd < 0)
+		{
+			::throw_file_error(errno, "打开输出文件失败");
+		}
 
+		struct stat status;
+		if (::fstat(fd, &status) != 0)
+		{
+			int error = errno;
+			::close(fd);
+			::throw_file_error(error, "获取输出文件信息失败");
+		}
+		if (status.st_dev == input.device && status.st_ino == input.inode)
+		{
+			::close(fd);
+			throw std::invalid_argument("输入文件和输出文件不能是同一个文件");
+		}
+		if (S_ISREG(status.st_mode) && ::ftruncate(fd, 0) != 0)
+		{
+			int error = errno;
+			::close(fd);
+			::throw_file_error(error, "清空输出文件失败");
+		}
+	}
 
-std::vector<wchar_t> extios::to_widechar_buffer(const std::u32string &text)
-{
-	return std::vector<wchar_t>(text.begin(), text.end());
-}
+	output_file(const output_file &) = delete;
+	output_file & operator=(const output_file &) = delete;
 
+	~output_file(void)
+	{
+		if (fd >= 0)
+		{
+			::close(fd);
+		}
+	}
 
-std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const std::u32string &text)
-{
-	throw_if_cvtor_null(cvtor);
-	return std::vector<wchar_t>(text.begin(), text.end());
-}
+	// 完整写入n个字节
+	// s 需要写入的数据
+	// n 字节数
+	void write(const void *s, std::size_t n)
+	{
+		auto p = static_cast<const char *>(s);
+		while (n != 0)
+		{
+			ssize_t length = ::write(fd, p, n);
+			if (length < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				::throw_file_error(errno, "写入输出文件失败");
+			}
+			p += length;
+			n -= static_cast<std::size_t>(length);
+		}
+	}
 
+	// 关闭文件, 报告延迟到关闭时的写入错误
+	void close(void)
+	{
+		int result = ::close(fd);
+		fd = -1;
+		if (result != 0 && errno != EINTR)
+		{
+			::throw_file_error(errno, "关闭输出文件失败");
+		}
+	}
 
-std::wstring extios::to_widechar(const char32_t *s, unsigned int n)
-{
-	return std::wstring(s, s + n);
-}
+	int fd; // 文件描述符
+};
 
 
-std::wstring extios::to_widechar(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, unsigned int n)
-{
-	throw_if_cvtor_null(cvtor);
-	return std::wstring(s, s + n);
-}
+#endif // _MSC_VER
 
 
-std::wstring extios::to_widechar(const std::u32string &text)
+// 字符集对应的字符类型
+template <extios::charset cs>
+struct charset_char
 {
-	return std::wstring(text.begin(), text.end());
-}
-
+	using type = char;
+};
 
-std::wstring extios::to_widechar(const codecvtor<charset::utf32, charset::widechar> &cvtor, const std::u32string &text)
+template <>
+struct charset_char<extios::charset::widechar>
 {
-	throw_if_cvtor_null(cvtor);
-	return std::wstring(text.begin(), text.end());
-}
-
+	using type = wchar_t;
+};
 
-std::vector<char> extios::to_utf8_buffer(const char *s, unsigned int n)
+template <>
+struct charset_char<extios::charset::utf16>
 {
-	throw_if_string_too_long(n);
-	return std::vector<char>(s, s + n);
-}
-
+	using type = char16_t;
+};
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const char *s, unsigned int n)
+template <>
+struct charset_char<extios::charset::utf32>
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return std::vector<char>(s, s + n);
-}
+	using type = char32_t;
+};
 
 
-std::vector<char> extios::to_utf8_buffer(const std::string &text)
-{
-	throw_if_string_too_long(text.size());
-	return std::vector<char>(text.begin(), text.end());
-}
+// 转换内存中的文件内容并写入输出文件
+// from 输入的字符集
+// to 输出的字符集
+// data 文件内容的首地址
+// size 文件的字节数
+// output 输出文件
+// policy 遇到无效字符时的处理方式
+// threads Unicode编码之间转换时最多使用的线程数
+// 返回值: 写入的字节数
+template <extios::charset from, extios::charset to>
+static std::uint64_t transcode_mapped(const char *data, std::size_t size, output_file &output, extios::error_policy policy, unsigned int threads)
+{
+	using InputCharType = typename charset_char<from>::type;
+	using OutputCharType = typename charset_char<to>::type;
+
+	// 末尾不足一个字符的字节按无效字符处理, 转换完其余字符后按照处理方式输出替换字符
+	bool truncated = size % sizeof(InputCharType) != 0;
+	if (truncated)
+	{
+		count_malformed();
+		if (policy == extios::error_policy::throw_exception)
+		{
+			throw_invalid_string();
+		}
+	}
+	auto s = reinterpret_cast<const InputCharType *>(data);
+	auto n = size / sizeof(InputCharType);
 
+	std::uint64_t total = 0;
+	if constexpr (from == extios::charset::multibyte && to == extios::charset::multibyte)
+	{
+		// 本地字符集之间不需要转换, 原样写出
+		static_cast<void>(threads);
+		output.write(s, n);
+		total = n;
+	}
+	else if constexpr (from == extios::charset::multibyte || to == extios::charset::multibyte)
+	{
+		// 本地字符集不能在任意位置分段, 整体转换后一次写出
+		static_cast<void>(threads);
+		extios::codecvtor<from, to> cvtor(policy);
+		auto text = [&]
+		{
+			if constexpr (to == extios::charset::multibyte)
+			{
+				return extios::to_multibyte(cvtor, s, n);
+			}
+			else if constexpr (to == extios::charset::widechar)
+			{
+				return extios::to_widechar(cvtor, s, n);
+			}
+			else if constexpr (to == extios::charset::utf8)
+			{
+				return extios::to_utf8(cvtor, s, n);
+			}
+			else if constexpr (to == extios::charset::utf16)
+			{
+				return extios::to_utf16(cvtor, s, n);
+			}
+			else
+			{
+				return extios::to_utf32(cvtor, s, n);
+			}
+		}();
+		output.write(text.data(), text.size() * sizeof(OutputCharType));
+		total = text.size() * sizeof(OutputCharType);
+	}
+	else if (from == to && sizeof(InputCharType) == 1 && ::validate_utf8(data, n))
+	{
+		// 有效的UTF-8原样写出, 包含无效字符时和其他Unicode编码一样按照处理方式转换
+		output.write(s, n);
+		total = n;
+	}
+	else if (sizeof(InputCharType) != sizeof(OutputCharType) && threads != 1)
+	{
+		// 多线程转换时各段同时输出到同一个缓冲, 整体转换后一次写出
+		// 编码单元大小相同时多线程转换直接复制, 不检查无效字符, 所以只用于大小不同的编码
+		auto text = ::utf_convert_parallel<std::vector<OutputCharType>>(s, n, policy, threads);
+		output.write(text.data(), text.size() * sizeof(OutputCharType));
+		total = text.size() * sizeof(OutputCharType);
+	}
+	else
+	{
+		// Unicode编码之间分块转换到固定大小的缓冲, 每填满一次写出一次
+		std::vector<OutputCharType> buffer(::file_buffer_size);
+		for (;;)
+		{
+			auto result = ::utf_try_convert_into(s, n, buffer.data(), buffer.size(), policy, false);
+			output.write(buffer.data(), result.written * sizeof(OutputCharType));
+			total += result.written * sizeof(OutputCharType);
+			if (policy == extios::error_policy::throw_exception && result.error_position != extios::try_convert_result::no_error)
+			{
+				throw_invalid_string();
+			}
+			if (result.status != extios::convert_status::insufficient_output)
+			{
+				break;
+			}
+			s += result.consumed;
+			n -= result.consumed;
+		}
+	}
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const std::string &text)
-{
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return std::vector<char>(text.begin(), text.end());
+	if (truncated && (policy == extios::error_policy::replace || policy == extios::error_policy::replace_with_question_mark))
+	{
+		char32_t cp = policy == extios::error_policy::replace ? 0xFFFD : '?';
+		if constexpr (to == extios::charset::multibyte)
+		{
+			extios::codecvtor<extios::charset::utf32, extios::charset::multibyte> cvtor(policy);
+			auto text = extios::to_multibyte_buffer(cvtor, &cp, 1);
+			output.write(text.data(), text.size());
+			total += text.size();
+		}
+		else
+		{
+			OutputCharType units[utf_codec<sizeof(OutputCharType)>::max_units];
+			auto length = static_cast<std::size_t>(utf_codec<sizeof(OutputCharType)>::encode(cp, units) - units);
+			output.write(units, length * sizeof(OutputCharType));
+			total += length * sizeof(OutputCharType);
+		}
+	}
+	return total;
 }
 
 
-std::string extios::to_utf8(const char *s, unsigned int n)
+// 按照输出的字符集选择转换函数
+// from 输入的字符集
+// data 文件内容的首地址
+// size 文件的字节数
+// to 输出的字符集
+// output 输出文件
+// policy 遇到无效字符时的处理方式
+// threads Unicode编码之间转换时最多使用的线程数
+// 返回值: 写入的字节数
+template <extios::charset from>
+static std::uint64_t transcode_mapped(const char *data, std::size_t size, extios::charset to, output_file &output, extios::error_policy policy, unsigned int threads)
 {
-	throw_if_string_too_long(n);
-	return std::string(s, s + n);
+	switch (to)
+	{
+	case extios::charset::multibyte:
+		return ::transcode_mapped<from, extios::charset::multibyte>(data, size, output, policy, threads);
+	case extios::charset::widechar:
+		return ::transcode_mapped<from, extios::charset::widechar>(data, size, output, policy, threads);
+	case extios::charset::utf8:
+		return ::transcode_mapped<from, extios::charset::utf8>(data, size, output, policy, threads);
+	case extios::charset::utf16:
+		return ::transcode_mapped<from, extios::charset::utf16>(data, size, output, policy, threads);
+	default:
+		return ::transcode_mapped<from, extios::charset::utf32>(data, size, output, policy, threads);
+	}
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const char *s, unsigned int n)
+extios::codecvtor_base::codecvtor_base(std::shared_ptr<member_data> &&data, error_policy policy)
+	: m_data(std::move(data))
+	, m_policy(policy)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return std::string(s, s + n);
 }
 
 
-std::string extios::to_utf8(const std::string &text)
+extios::codecvtor_base::codecvtor_base(codecvtor_base &&data) noexcept
+	: m_data(std::move(data.m_data))
+	, m_policy(data.m_policy)
 {
-	throw_if_string_too_long(text.size());
-	return std::string(text.begin(), text.end());
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const std::string &text)
+extios::codecvtor_base & extios::codecvtor_base::operator=(codecvtor_base &&data) noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return std::string(text.begin(), text.end());
+	m_data = std::move(data.m_data);
+	m_policy = data.m_policy;
+	return *this;
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const wchar_t *s, unsigned int n)
+extios::error_policy extios::codecvtor_base::policy(void) const noexcept
 {
-	throw_if_string_too_long(n);
-	codecvtor<charset::widechar, charset::utf8> cvtor;
-	return ::convert_to<char>(cvtor, s, n, n * 4);
+	return m_policy;
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, unsigned int n)
+bool extios::codecvtor_base::operator==(std::nullptr_t pointer) const noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::convert_to<char>(cvtor, s, n, n * 4);
+	return m_data == pointer;
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const std::wstring &text)
+bool extios::codecvtor_base::operator!=(std::nullptr_t pointer) const noexcept
 {
-	throw_if_string_too_long(text.size());
-	codecvtor<charset::widechar, charset::utf8> cvtor;
-	return ::convert_to<char>(cvtor, text.c_str(), text.size(), text.size() * 4);
+	return m_data != pointer;
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const std::wstring &text)
+extios::codecvtor_base::operator bool(void) const noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::convert_to<char>(cvtor, text.c_str(), text.size(), text.size() * 4);
+	return m_data != nullptr;
 }
 
 
-std::string extios::to_utf8(const wchar_t *s, unsigned int n)
+extios::convert_result extios::convert_into(const wchar_t *s, std::size_t n, char *dest, std::size_t capacity)
 {
-	auto buffer = to_utf8_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::widechar, charset::utf8, n, ::utf_convert_into(s, n, dest, capacity));
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, unsigned int n)
+extios::convert_result extios::convert_into(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, std::size_t n, char *dest, std::size_t capacity)
 {
-	auto buffer = to_utf8_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf8, n, ::utf_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::string extios::to_utf8(const std::wstring &text)
+extios::convert_result extios::convert_into(const wchar_t *s, std::size_t n, char16_t *dest, std::size_t capacity)
 {
-	auto buffer = to_utf8_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::widechar, charset::utf16, n, ::utf_convert_into(s, n, dest, capacity));
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::widechar, charset::utf8> &cvtor, const std::wstring &text)
+extios::convert_result extios::convert_into(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, std::size_t n, char16_t *dest, std::size_t capacity)
 {
-	auto buffer = to_utf8_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf16, n, ::utf_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const char16_t *s, unsigned int n)
+extios::convert_result extios::convert_into(const wchar_t *s, std::size_t n, char32_t *dest, std::size_t capacity)
 {
-	throw_if_string_too_long(n);
-	codecvtor<charset::utf16, charset::utf8> cvtor;
-	return ::convert_to<char>(cvtor, s, n, n * 4);
+	return record_stats(charset::widechar, charset::utf32, n, ::utf_convert_into(s, n, dest, capacity));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, unsigned int n)
+extios::convert_result extios::convert_into(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, std::size_t n, char32_t *dest, std::size_t capacity)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::convert_to<char>(cvtor, s, n, n * 4);
+	return record_stats(charset::widechar, charset::utf32, n, ::utf_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const std::u16string &text)
+extios::convert_result extios::convert_into(const char *s, std::size_t n, wchar_t *dest, std::size_t capacity)
 {
-	throw_if_string_too_long(text.size());
-	codecvtor<charset::utf16, charset::utf8> cvtor;
-	return ::convert_to<char>(cvtor, text.c_str(), text.size(), text.size() * 4);
+	return record_stats(charset::utf8, charset::widechar, n, ::utf_convert_into(s, n, dest, capacity));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const std::u16string &text)
+extios::convert_result extios::convert_into(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, std::size_t n, wchar_t *dest, std::size_t capacity)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::convert_to<char>(cvtor, text.c_str(), text.size(), text.size() * 4);
+	return record_stats(charset::utf8, charset::widechar, n, ::utf_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::string extios::to_utf8(const char16_t *s, unsigned int n)
+extios::convert_result extios::convert_into(const char *s, std::size_t n, char16_t *dest, std::size_t capacity)
 {
-	auto buffer = to_utf8_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf8, charset::utf16, n, ::utf_convert_into(s, n, dest, capacity));
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, unsigned int n)
+extios::convert_result extios::convert_into(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, std::size_t n, char16_t *dest, std::size_t capacity)
 {
-	auto buffer = to_utf8_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf16, n, ::utf_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::string extios::to_utf8(const std::u16string &text)
+extios::convert_result extios::convert_into(const char *s, std::size_t n, char32_t *dest, std::size_t capacity)
 {
-	auto buffer = to_utf8_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf8, charset::utf32, n, ::utf_convert_into(s, n, dest, capacity));
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::utf16, charset::utf8> &cvtor, const std::u16string &text)
+extios::convert_result extios::convert_into(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, std::size_t n, char32_t *dest, std::size_t capacity)
 {
-	auto buffer = to_utf8_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf32, n, ::utf_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const char32_t *s, unsigned int n)
+extios::convert_result extios::convert_into(const char16_t *s, std::size_t n, wchar_t *dest, std::size_t capacity)
 {
-	throw_if_string_too_long(n);
-	codecvtor<charset::utf32, charset::utf8> cvtor;
-	return ::convert_to<char>(cvtor, s, n, n * 4);
+	return record_stats(charset::utf16, charset::widechar, n, ::utf_convert_into(s, n, dest, capacity));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, unsigned int n)
+extios::convert_result extios::convert_into(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, std::size_t n, wchar_t *dest, std::size_t capacity)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::convert_to<char>(cvtor, s, n, n * 4);
+	return record_stats(charset::utf16, charset::widechar, n, ::utf_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const std::u32string &text)
+extios::convert_result extios::convert_into(const char16_t *s, std::size_t n, char *dest, std::size_t capacity)
 {
-	throw_if_string_too_long(text.size());
-	codecvtor<charset::utf32, charset::utf8> cvtor;
-	return ::convert_to<char>(cvtor, text.c_str(), text.size(), text.size() * 4);
+	return record_stats(charset::utf16, charset::utf8, n, ::utf_convert_into(s, n, dest, capacity));
 }
 
 
-std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const std::u32string &text)
+extios::convert_result extios::convert_into(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, std::size_t n, char *dest, std::size_t capacity)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::convert_to<char>(cvtor, text.c_str(), text.size(), text.size() * 4);
-}
-
-
-std::string extios::to_utf8(const char32_t *s, unsigned int n)
-{
-	auto buffer = to_utf8_buffer(s, n);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf16, charset::utf8, n, ::utf_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, unsigned int n)
+extios::convert_result extios::convert_into(const char16_t *s, std::size_t n, char32_t *dest, std::size_t capacity)
 {
-	auto buffer = to_utf8_buffer(cvtor, s, n);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf16, charset::utf32, n, ::utf_convert_into(s, n, dest, capacity));
 }
 
 
-std::string extios::to_utf8(const std::u32string &text)
+extios::convert_result extios::convert_into(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, std::size_t n, char32_t *dest, std::size_t capacity)
 {
-	auto buffer = to_utf8_buffer(text);
-	return std::string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf32, n, ::utf_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::string extios::to_utf8(const codecvtor<charset::utf32, charset::utf8> &cvtor, const std::u32string &text)
+extios::convert_result extios::convert_into(const char32_t *s, std::size_t n, wchar_t *dest, std::size_t capacity)
 {
-	auto buffer = to_utf8_buffer(cvtor, text);
-	return std::string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf32, charset::widechar, n, ::utf_convert_into(s, n, dest, capacity));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const char *s, unsigned int n, bool)
+extios::convert_result extios::convert_into(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, std::size_t n, wchar_t *dest, std::size_t capacity)
 {
-	throw_if_string_too_long(n);
-	codecvtor<charset::multibyte, charset::utf16> cvtor;
-	return ::convert_to<char16_t>(cvtor, s, n, n * 2);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::widechar, n, ::utf_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const char *s, unsigned int n)
+extios::convert_result extios::convert_into(const char32_t *s, std::size_t n, char *dest, std::size_t capacity)
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::convert_to<char16_t>(cvtor, s, n, n * 2);
+	return record_stats(charset::utf32, charset::utf8, n, ::utf_convert_into(s, n, dest, capacity));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, unsigned int n)
+extios::convert_result extios::convert_into(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, std::size_t n, char *dest, std::size_t capacity)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::convert_to<char16_t>(cvtor, s, n, n * 2);
+	return record_stats(charset::utf32, charset::utf8, n, ::utf_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const std::string &text, bool)
+extios::convert_result extios::convert_into(const char32_t *s, std::size_t n, char16_t *dest, std::size_t capacity)
 {
-	throw_if_string_too_long(text.size());
-	codecvtor<charset::multibyte, charset::utf16> cvtor;
-	return ::convert_to<char16_t>(cvtor, text.c_str(), text.size(), text.size() * 2);
+	return record_stats(charset::utf32, charset::utf16, n, ::utf_convert_into(s, n, dest, capacity));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const std::string &text)
+extios::convert_result extios::convert_into(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, std::size_t n, char16_t *dest, std::size_t capacity)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::convert_to<char16_t>(cvtor, text.c_str(), text.size(), text.size() * 2);
+	return record_stats(charset::utf32, charset::utf16, n, ::utf_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const std::string &text)
+extios::try_convert_result extios::try_convert_into(const wchar_t *s, std::size_t n, char *dest, std::size_t capacity) noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::convert_to<char16_t>(cvtor, text.c_str(), text.size(), text.size() * 2);
+	return record_stats(charset::widechar, charset::utf8, n, ::utf_try_convert_into(s, n, dest, capacity));
 }
 
 
-std::u16string extios::to_utf16(const char *s, unsigned int n, bool isutf8)
+extios::try_convert_result extios::try_convert_into(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, std::size_t n, char *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(s, n, isutf8);
-	return std::u16string(buffer.begin(), buffer.end());
+	if (cvtor == nullptr)
+	{
+		return record_stats(charset::widechar, charset::utf8, n, try_convert_result{ convert_status::null_convertor, 0, 0, try_convert_result::no_error });
+	}
+	return record_stats(charset::widechar, charset::utf8, n, ::utf_try_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const char *s, unsigned int n)
+extios::try_convert_result extios::try_convert_into(const wchar_t *s, std::size_t n, char16_t *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(cvtor, s, n);
-	return std::u16string(buffer.begin(), buffer.end());
+	return record_stats(charset::widechar, charset::utf16, n, ::utf_try_convert_into(s, n, dest, capacity));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, unsigned int n)
+extios::try_convert_result extios::try_convert_into(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, std::size_t n, char16_t *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(cvtor, s, n);
-	return std::u16string(buffer.begin(), buffer.end());
+	if (cvtor == nullptr)
+	{
+		return record_stats(charset::widechar, charset::utf16, n, try_convert_result{ convert_status::null_convertor, 0, 0, try_convert_result::no_error });
+	}
+	return record_stats(charset::widechar, charset::utf16, n, ::utf_try_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const std::string &text, bool isutf8)
+extios::try_convert_result extios::try_convert_into(const wchar_t *s, std::size_t n, char32_t *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(text, isutf8);
-	return std::u16string(buffer.begin(), buffer.end());
+	return record_stats(charset::widechar, charset::utf32, n, ::utf_try_convert_into(s, n, dest, capacity));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const std::string &text)
+extios::try_convert_result extios::try_convert_into(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, std::size_t n, char32_t *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(cvtor, text);
-	return std::u16string(buffer.begin(), buffer.end());
+	if (cvtor == nullptr)
+	{
+		return record_stats(charset::widechar, charset::utf32, n, try_convert_result{ convert_status::null_convertor, 0, 0, try_convert_result::no_error });
+	}
+	return record_stats(charset::widechar, charset::utf32, n, ::utf_try_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::utf8, charset::utf16> &cvtor, const std::string &text)
+extios::try_convert_result extios::try_convert_into(const char *s, std::size_t n, wchar_t *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(cvtor, text);
-	return std::u16string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf8, charset::widechar, n, ::utf_try_convert_into(s, n, dest, capacity));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const wchar_t *s, unsigned int n)
+extios::try_convert_result extios::try_convert_into(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, std::size_t n, wchar_t *dest, std::size_t capacity) noexcept
 {
-	codecvtor<charset::widechar, charset::utf16> cvtor;
-	return ::convert_to<char16_t>(cvtor, s, n, n * 2);
+	if (cvtor == nullptr)
+	{
+		return record_stats(charset::utf8, charset::widechar, n, try_convert_result{ convert_status::null_convertor, 0, 0, try_convert_result::no_error });
+	}
+	return record_stats(charset::utf8, charset::widechar, n, ::utf_try_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, unsigned int n)
+extios::try_convert_result extios::try_convert_into(const char *s, std::size_t n, char16_t *dest, std::size_t capacity) noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	return ::convert_to<char16_t>(cvtor, s, n, n * 2);
+	return record_stats(charset::utf8, charset::utf16, n, ::utf_try_convert_into(s, n, dest, capacity));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const std::wstring &text)
+extios::try_convert_result extios::try_convert_into(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, std::size_t n, char16_t *dest, std::size_t capacity) noexcept
 {
-	codecvtor<charset::widechar, charset::utf16> cvtor;
-	return ::convert_to<char16_t>(cvtor, text.c_str(), text.size(), text.size() * 2);
+	if (cvtor == nullptr)
+	{
+		return record_stats(charset::utf8, charset::utf16, n, try_convert_result{ convert_status::null_convertor, 0, 0, try_convert_result::no_error });
+	}
+	return record_stats(charset::utf8, charset::utf16, n, ::utf_try_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const std::wstring &text)
+extios::try_convert_result extios::try_convert_into(const char *s, std::size_t n, char32_t *dest, std::size_t capacity) noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	return ::convert_to<char16_t>(cvtor, text.c_str(), text.size(), text.size() * 2);
+	return record_stats(charset::utf8, charset::utf32, n, ::utf_try_convert_into(s, n, dest, capacity));
 }
 
 
-std::u16string extios::to_utf16(const wchar_t *s, unsigned int n)
+extios::try_convert_result extios::try_convert_into(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, std::size_t n, char32_t *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(s, n);
-	return std::u16string(buffer.begin(), buffer.end());
+	if (cvtor == nullptr)
+	{
+		return record_stats(charset::utf8, charset::utf32, n, try_convert_result{ convert_status::null_convertor, 0, 0, try_convert_result::no_error });
+	}
+	return record_stats(charset::utf8, charset::utf32, n, ::utf_try_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, unsigned int n)
+extios::try_convert_result extios::try_convert_into(const char16_t *s, std::size_t n, wchar_t *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(cvtor, s, n);
-	return std::u16string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf16, charset::widechar, n, ::utf_try_convert_into(s, n, dest, capacity));
 }
 
 
-std::u16string extios::to_utf16(const std::wstring &text)
+extios::try_convert_result extios::try_convert_into(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, std::size_t n, wchar_t *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(text);
-	return std::u16string(buffer.begin(), buffer.end());
+	if (cvtor == nullptr)
+	{
+		return record_stats(charset::utf16, charset::widechar, n, try_convert_result{ convert_status::null_convertor, 0, 0, try_convert_result::no_error });
+	}
+	return record_stats(charset::utf16, charset::widechar, n, ::utf_try_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::widechar, charset::utf16> &cvtor, const std::wstring &text)
+extios::try_convert_result extios::try_convert_into(const char16_t *s, std::size_t n, char *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(cvtor, text);
-	return std::u16string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf16, charset::utf8, n, ::utf_try_convert_into(s, n, dest, capacity));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const char32_t *s, unsigned int n)
+extios::try_convert_result extios::try_convert_into(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, std::size_t n, char *dest, std::size_t capacity) noexcept
 {
-	codecvtor<charset::utf32, charset::utf16> cvtor;
-	return ::convert_to<char16_t>(cvtor, s, n, n * 2);
+	if (cvtor == nullptr)
+	{
+		return record_stats(charset::utf16, charset::utf8, n, try_convert_result{ convert_status::null_convertor, 0, 0, try_convert_result::no_error });
+	}
+	return record_stats(charset::utf16, charset::utf8, n, ::utf_try_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, unsigned int n)
+extios::try_convert_result extios::try_convert_into(const char16_t *s, std::size_t n, char32_t *dest, std::size_t capacity) noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	return ::convert_to<char16_t>(cvtor, s, n, n * 2);
+	return record_stats(charset::utf16, charset::utf32, n, ::utf_try_convert_into(s, n, dest, capacity));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const std::u32string &text)
+extios::try_convert_result extios::try_convert_into(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, std::size_t n, char32_t *dest, std::size_t capacity) noexcept
 {
-	codecvtor<charset::utf32, charset::utf16> cvtor;
-	return ::convert_to<char16_t>(cvtor, text.c_str(), text.size(), text.size() * 2);
+	if (cvtor == nullptr)
+	{
+		return record_stats(charset::utf16, charset::utf32, n, try_convert_result{ convert_status::null_convertor, 0, 0, try_convert_result::no_error });
+	}
+	return record_stats(charset::utf16, charset::utf32, n, ::utf_try_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const std::u32string &text)
+extios::try_convert_result extios::try_convert_into(const char32_t *s, std::size_t n, wchar_t *dest, std::size_t capacity) noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	return ::convert_to<char16_t>(cvtor, text.c_str(), text.size(), text.size() * 2);
+	return record_stats(charset::utf32, charset::widechar, n, ::utf_try_convert_into(s, n, dest, capacity));
 }
 
 
-std::u16string extios::to_utf16(const char32_t *s, unsigned int n)
+extios::try_convert_result extios::try_convert_into(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, std::size_t n, wchar_t *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(s, n);
-	return std::u16string(buffer.begin(), buffer.end());
+	if (cvtor == nullptr)
+	{
+		return record_stats(charset::utf32, charset::widechar, n, try_convert_result{ convert_status::null_convertor, 0, 0, try_convert_result::no_error });
+	}
+	return record_stats(charset::utf32, charset::widechar, n, ::utf_try_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, unsigned int n)
+extios::try_convert_result extios::try_convert_into(const char32_t *s, std::size_t n, char *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(cvtor, s, n);
-	return std::u16string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf32, charset::utf8, n, ::utf_try_convert_into(s, n, dest, capacity));
 }
 
 
-std::u16string extios::to_utf16(const std::u32string &text)
+extios::try_convert_result extios::try_convert_into(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, std::size_t n, char *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(text);
-	return std::u16string(buffer.begin(), buffer.end());
+	if (cvtor == nullptr)
+	{
+		return record_stats(charset::utf32, charset::utf8, n, try_convert_result{ convert_status::null_convertor, 0, 0, try_convert_result::no_error });
+	}
+	return record_stats(charset::utf32, charset::utf8, n, ::utf_try_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::u16string extios::to_utf16(const codecvtor<charset::utf32, charset::utf16> &cvtor, const std::u32string &text)
+extios::try_convert_result extios::try_convert_into(const char32_t *s, std::size_t n, char16_t *dest, std::size_t capacity) noexcept
 {
-	auto buffer = to_utf16_buffer(cvtor, text);
-	return std::u16string(buffer.begin(), buffer.end());
+	return record_stats(charset::utf32, charset::utf16, n, ::utf_try_convert_into(s, n, dest, capacity));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const char *s, unsigned int n, bool)
+extios::try_convert_result extios::try_convert_into(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, std::size_t n, char16_t *dest, std::size_t capacity) noexcept
 {
-	throw_if_string_too_long(n);
-	codecvtor<charset::multibyte, charset::utf32> cvtor;
-	return ::convert_to<char32_t>(cvtor, s, n, n);
+	if (cvtor == nullptr)
+	{
+		return record_stats(charset::utf32, charset::utf16, n, try_convert_result{ convert_status::null_convertor, 0, 0, try_convert_result::no_error });
+	}
+	return record_stats(charset::utf32, charset::utf16, n, ::utf_try_convert_into(s, n, dest, capacity, cvtor.policy()));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const char *s, unsigned int n)
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, std::size_t n, unsigned int threads)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::convert_to<char32_t>(cvtor, s, n, n);
+	return record_stats(charset::widechar, charset::utf8, n, ::utf_convert_parallel<std::vector<char>>(s, n, cvtor.policy(), threads));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, unsigned int n)
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, std::size_t n, unsigned int threads)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(n);
-	return ::convert_to<char32_t>(cvtor, s, n, n);
+	return record_stats(charset::widechar, charset::utf16, n, ::utf_convert_parallel<std::vector<char16_t>>(s, n, cvtor.policy(), threads));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const std::string &text, bool)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, std::size_t n, unsigned int threads)
 {
-	throw_if_string_too_long(text.size());
-	codecvtor<charset::multibyte, charset::utf32> cvtor;
-	return ::convert_to<char32_t>(cvtor, text.c_str(), text.size(), text.size());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::widechar, charset::utf32, n, ::utf_convert_parallel<std::vector<char32_t>>(s, n, cvtor.policy(), threads));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const std::string &text)
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, std::size_t n, unsigned int threads)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::convert_to<char32_t>(cvtor, text.c_str(), text.size(), text.size());
+	return record_stats(charset::utf8, charset::widechar, n, ::utf_convert_parallel<std::vector<wchar_t>>(s, n, cvtor.policy(), threads));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const std::string &text)
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, std::size_t n, unsigned int threads)
 {
 	throw_if_cvtor_null(cvtor);
-	throw_if_string_too_long(text.size());
-	return ::convert_to<char32_t>(cvtor, text.c_str(), text.size(), text.size());
+	return record_stats(charset::utf8, charset::utf16, n, ::utf_convert_parallel<std::vector<char16_t>>(s, n, cvtor.policy(), threads));
 }
 
 
-std::u32string extios::to_utf32(const char *s, unsigned int n, bool isutf8)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, std::size_t n, unsigned int threads)
 {
-	auto buffer = to_utf32_buffer(s, n, isutf8);
-	return std::u32string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf8, charset::utf32, n, ::utf_convert_parallel<std::vector<char32_t>>(s, n, cvtor.policy(), threads));
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const char *s, unsigned int n)
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, std::size_t n, unsigned int threads)
 {
-	auto buffer = to_utf32_buffer(cvtor, s, n);
-	return std::u32string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::widechar, n, ::utf_convert_parallel<std::vector<wchar_t>>(s, n, cvtor.policy(), threads));
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, unsigned int n)
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, std::size_t n, unsigned int threads)
 {
-	auto buffer = to_utf32_buffer(cvtor, s, n);
-	return std::u32string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf8, n, ::utf_convert_parallel<std::vector<char>>(s, n, cvtor.policy(), threads));
 }
 
 
-std::u32string extios::to_utf32(const std::string &text, bool isutf8)
+std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, std::size_t n, unsigned int threads)
 {
-	auto buffer = to_utf32_buffer(text, isutf8);
-	return std::u32string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf16, charset::utf32, n, ::utf_convert_parallel<std::vector<char32_t>>(s, n, cvtor.policy(), threads));
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const std::string &text)
+std::vector<wchar_t> extios::to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, std::size_t n, unsigned int threads)
 {
-	auto buffer = to_utf32_buffer(cvtor, text);
-	return std::u32string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::widechar, n, ::utf_convert_parallel<std::vector<wchar_t>>(s, n, cvtor.policy(), threads));
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::utf8, charset::utf32> &cvtor, const std::string &text)
+std::vector<char> extios::to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, std::size_t n, unsigned int threads)
 {
-	auto buffer = to_utf32_buffer(cvtor, text);
-	return std::u32string(buffer.begin(), buffer.end());
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::utf8, n, ::utf_convert_parallel<std::vector<char>>(s, n, cvtor.policy(), threads));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const wchar_t *s, unsigned int n)
+std::vector<char16_t> extios::to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, std::size_t n, unsigned int threads)
 {
-	return std::vector<char32_t>(s, s + n);
+	throw_if_cvtor_null(cvtor);
+	return record_stats(charset::utf32, charset::utf16, n, ::utf_convert_parallel<std::vector<char16_t>>(s, n, cvtor.policy(), threads));
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, unsigned int n)
+std::uint64_t extios::transcode_file(const char *path_in, charset from, const char *path_out, charset to, error_policy policy, unsigned int threads)
 {
-	throw_if_cvtor_null(cvtor);
-	return std::vector<char32_t>(s, s + n);
+	if (from < charset::multibyte || from > charset::utf32 || to < charset::multibyte || to > charset::utf32)
+	{
+		throw std::invalid_argument("字符集无效");
+	}
+
+	::mapped_file input(path_in);
+	::output_file output(path_out, input);
+#ifdef EXTIOS_STATS
+	::stats_scope scope(from, to, input.size / ::unit_size(from));
+#endif // EXTIOS_STATS
+	std::uint64_t written = 0;
+	switch (from)
+	{
+	case charset::multibyte:
+		written = ::transcode_mapped<charset::multibyte>(input.data, input.size, to, output, policy, threads);
+		break;
+	case charset::widechar:
+		written = ::transcode_mapped<charset::widechar>(input.data, input.size, to, output, policy, threads);
+		break;
+	case charset::utf8:
+		written = ::transcode_mapped<charset::utf8>(input.data, input.size, to, output, policy, threads);
+		break;
+	case charset::utf16:
+		written = ::transcode_mapped<charset::utf16>(input.data, input.size, to, output, policy, threads);
+		break;
+	default:
+		written = ::transcode_mapped<charset::utf32>(input.data, input.size, to, output, policy, threads);
+		break;
+	}
+	output.close();
+#ifdef EXTIOS_STATS
+	scope.finish_file(written);
+#endif // EXTIOS_STATS
+	return written;
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const std::wstring &text)
+std::size_t extios::widechar_length_from_utf8(const char *s, std::size_t n) noexcept
 {
-	return std::vector<char32_t>(text.begin(), text.end());
+	return ::utf_length<wchar_t>(s, n);
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const std::wstring &text)
+std::size_t extios::widechar_length_from_utf16(const char16_t *s, std::size_t n) noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	return std::vector<char32_t>(text.begin(), text.end());
+	return ::utf_length<wchar_t>(s, n);
 }
 
 
-std::u32string extios::to_utf32(const wchar_t *s, unsigned int n)
+std::size_t extios::widechar_length_from_utf32(const char32_t *s, std::size_t n) noexcept
 {
-	return std::u32string(s, s + n);
+	return ::utf_length<wchar_t>(s, n);
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, unsigned int n)
+std::size_t extios::utf8_length_from_widechar(const wchar_t *s, std::size_t n) noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	return std::u32string(s, s + n);
+	return ::utf_length<char>(s, n);
 }
 
 
-std::u32string extios::to_utf32(const std::wstring &text)
+std::size_t extios::utf8_length_from_utf16(const char16_t *s, std::size_t n) noexcept
 {
-	return std::u32string(text.begin(), text.end());
+	return ::utf_length<char>(s, n);
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::widechar, charset::utf32> &cvtor, const std::wstring &text)
+std::size_t extios::utf8_length_from_utf32(const char32_t *s, std::size_t n) noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	return std::u32string(text.begin(), text.end());
+	return ::utf_length<char>(s, n);
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const char16_t *s, unsigned int n)
+std::size_t extios::utf16_length_from_widechar(const wchar_t *s, std::size_t n) noexcept
 {
-	codecvtor<charset::utf16, charset::utf32> cvtor;
-	return ::convert_to<char32_t>(cvtor, s, n, n);
+	return ::utf_length<char16_t>(s, n);
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, unsigned int n)
+std::size_t extios::utf16_length_from_utf8(const char *s, std::size_t n) noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	return ::convert_to<char32_t>(cvtor, s, n, n);
+	return ::utf_length<char16_t>(s, n);
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const std::u16string &text)
+std::size_t extios::utf16_length_from_utf32(const char32_t *s, std::size_t n) noexcept
 {
-	codecvtor<charset::utf16, charset::utf32> cvtor;
-	return ::convert_to<char32_t>(cvtor, text.c_str(), text.size(), text.size());
+	return ::utf_length<char16_t>(s, n);
 }
 
 
-std::vector<char32_t> extios::to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const std::u16string &text)
+std::size_t extios::utf32_length_from_widechar(const wchar_t *s, std::size_t n) noexcept
 {
-	throw_if_cvtor_null(cvtor);
-	return ::convert_to<char32_t>(cvtor, text.c_str(), text.size(), text.size());
+	return ::utf_length<char32_t>(s, n);
 }
 
 
-std::u32string extios::to_utf32(const char16_t *s, unsigned int n)
+std::size_t extios::utf32_length_from_utf8(const char *s, std::size_t n) noexcept
 {
-	auto buffer = to_utf32_buffer(s, n);
-	return std::u32string(buffer.begin(), buffer.end());
+	return ::utf_length<char32_t>(s, n);
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, unsigned int n)
+std::size_t extios::utf32_length_from_utf16(const char16_t *s, std::size_t n) noexcept
 {
-	auto buffer = to_utf32_buffer(cvtor, s, n);
-	return std::u32string(buffer.begin(), buffer.end());
+	return ::utf_length<char32_t>(s, n);
 }
 
 
-std::u32string extios::to_utf32(const std::u16string &text)
+bool extios::is_valid_utf8(const char *s, std::size_t n) noexcept
 {
-	auto buffer = to_utf32_buffer(text);
-	return std::u32string(buffer.begin(), buffer.end());
+	return ::validate_utf8(s, n);
 }
 
 
-std::u32string extios::to_utf32(const codecvtor<charset::utf16, charset::utf32> &cvtor, const std::u16string &text)
+bool extios::is_valid_utf8(const std::string &text) noexcept
 {
-	auto buffer = to_utf32_buffer(cvtor, text);
-	return std::u32string(buffer.begin(), buffer.end());
+	return ::validate_utf8(text.c_str(), text.size());
 }
 
 
-#endif // _MSC_VER
-
-
-extios::codecvtor_base::codecvtor_base(std::shared_ptr<member_data> &&data)
-	: m_data(std::move(data))
+extios::implementation extios::best_implementation(void) noexcept
 {
+	return ::best_kernels()->level;
 }
 
 
-extios::codecvtor_base::codecvtor_base(codecvtor_base &&data) noexcept
-	: m_data(std::move(data.m_data))
+extios::implementation extios::active_implementation(void) noexcept
 {
+	return ::active_kernels.load(std::memory_order_relaxed)->level;
 }
 
 
-extios::codecvtor_base & extios::codecvtor_base::operator=(codecvtor_base &&data) noexcept
+bool extios::set_implementation(implementation level) noexcept
 {
-	m_data = std::move(data.m_data);
-	return *this;
+	auto kernels = ::find_kernels(level);
+	if (kernels == nullptr)
+	{
+		return false;
+	}
+	::active_kernels.store(kernels, std::memory_order_relaxed);
+	return true;
 }
 
 
-bool extios::codecvtor_base::operator==(std::nullptr_t pointer) const noexcept
+const extios::conversion_stats & extios::codecvt_stats::at(charset from, charset to) const noexcept
 {
-	return m_data == pointer;
+	return pairs[static_cast<std::size_t>(from)][static_cast<std::size_t>(to)];
 }
 
 
-bool extios::codecvtor_base::operator!=(std::nullptr_t pointer) const noexcept
+extios::codecvt_stats extios::stats(void) noexcept
 {
-	return m_data != pointer;
+	codecvt_stats result{};
+#ifdef EXTIOS_STATS
+	static_assert(::charset_count == sizeof(result.pairs) / sizeof(result.pairs[0]), "The statistics table must cover every charset.");
+	result.enabled = true;
+	for (std::size_t from = 0; from < ::charset_count; ++from)
+	{
+		for (std::size_t to = 0; to < ::charset_count; ++to)
+		{
+			auto &counters = ::all_counters[from][to];
+			auto &pair = result.pairs[from][to];
+			pair.calls = counters.calls.load(std::memory_order_relaxed);
+			pair.input_units = counters.input_units.load(std::memory_order_relaxed);
+			pair.output_units = counters.output_units.load(std::memory_order_relaxed);
+			pair.malformed = counters.malformed.load(std::memory_order_relaxed);
+			pair.allocated_bytes = counters.allocated_bytes.load(std::memory_order_relaxed);
+			pair.nanoseconds = counters.nanoseconds.load(std::memory_order_relaxed);
+		}
+	}
+#endif // EXTIOS_STATS
+	return result;
 }
 
 
-extios::codecvtor_base::operator bool(void) const noexcept
+void extios::reset_stats(void) noexcept
 {
-	return m_data != nullptr;
+#ifdef EXTIOS_STATS
+	for (auto &row : ::all_counters)
+	{
+		for (auto &counters : row)
+		{
+			counters.calls.store(0, std::memory_order_relaxed);
+			counters.input_units.store(0, std::memory_order_relaxed);
+			counters.output_units.store(0, std::memory_order_relaxed);
+			counters.malformed.store(0, std::memory_order_relaxed);
+			counters.allocated_bytes.store(0, std::memory_order_relaxed);
+			counters.nanoseconds.store(0, std::memory_order_relaxed);
+		}
+	}
+#endif // EXTIOS_STATS
 }
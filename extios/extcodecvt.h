@@ -2,6 +2,7 @@
 #define __EXTIOS_CODECVT_H__
 
 #include <memory> // std::shared_ptr
+#include <cstdint> // std::uint64_t
 #include <vector> // std::vector
 #include <string> // std::string std::wstring std::u16string std::u32string
 
@@ -29,6 +30,25 @@ namespace extios
 		utf32 // UTF-32
 	};
 
+	// Unicode编码转换的实现方式
+	enum class implementation
+	{
+		scalar, // 逐个字符转换
+		sse42, // 使用SSE4.2指令集
+		avx2 // 使用AVX2指令集
+	};
+
+	// 遇到无效字符时的处理方式
+	// 只对Unicode编码之间的转换有效, 相同编码之间直接复制, Windows上本地字符集的转换由系统替换无效字符
+	enum class error_policy
+	{
+		throw_exception, // 抛出std::invalid_argument异常
+		replace, // 替换成U+FFFD
+		replace_with_question_mark, // 替换成'?'
+		skip, // 丢弃无效的字符
+		stop // 在无效的字符处停止, 返回之前已转换的部分
+	};
+
 	// 编码转换基类, 只能用于extios库内部继承, 不能实例化对象
 	class codecvtor_base
 	{
@@ -49,11 +69,16 @@ namespace extios
 
 		EXTIOSAPI void * handle(void) const noexcept;
 
+		// 获取遇到无效字符时的处理方式
+		// 返回值: 构造时指定的处理方式
+		EXTIOSAPI error_policy policy(void) const noexcept;
+
 	protected:
-		EXTIOSAPI explicit codecvtor_base(std::shared_ptr<member_data> &&data);
+		EXTIOSAPI codecvtor_base(std::shared_ptr<member_data> &&data, error_policy policy);
 
 	protected:
 		std::shared_ptr<member_data> m_data;
+		error_policy m_policy;
 	};
 
 	// 编码转换类
@@ -67,163 +92,200 @@ namespace extios
 	template <> class codecvtor<charset::multibyte, charset::widechar> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于本地字符集转换成UTF-8的编码转换类
 	template <> class codecvtor<charset::multibyte, charset::utf8> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于本地字符集转换成UTF-16的编码转换类
 	template <> class codecvtor<charset::multibyte, charset::utf16> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于本地字符集转换成UTF-32的编码转换类
 	template <> class codecvtor<charset::multibyte, charset::utf32> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于宽字符字符集转换成本地字符集的编码转换类
 	template <> class codecvtor<charset::widechar, charset::multibyte> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于宽字符字符集转换成UTF-8的编码转换类
 	template <> class codecvtor<charset::widechar, charset::utf8> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于宽字符字符集转换成UTF-16的编码转换类
 	template <> class codecvtor<charset::widechar, charset::utf16> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于宽字符字符集转换成UTF-32的编码转换类
 	template <> class codecvtor<charset::widechar, charset::utf32> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于UTF-8转换成本地字符集的编码转换类
 	template <> class codecvtor<charset::utf8, charset::multibyte> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于UTF-8转换成宽字符字符集的编码转换类
 	template <> class codecvtor<charset::utf8, charset::widechar> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于UTF-8转换成UTF-16的编码转换类
 	template <> class codecvtor<charset::utf8, charset::utf16> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于UTF-8转换成UTF-32的编码转换类
 	template <> class codecvtor<charset::utf8, charset::utf32> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于UTF-16转换成本地字符集的编码转换类
 	template <> class codecvtor<charset::utf16, charset::multibyte> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于UTF-16转换成宽字符字符集的编码转换类
 	template <> class codecvtor<charset::utf16, charset::widechar> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于UTF-16转换成UTF-8的编码转换类
 	template <> class codecvtor<charset::utf16, charset::utf8> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于UTF-16转换成UTF-32的编码转换类
 	template <> class codecvtor<charset::utf16, charset::utf32> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于UTF-32转换成本地字符集的编码转换类
 	template <> class codecvtor<charset::utf32, charset::multibyte> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于UTF-32转换成宽字符字符集的编码转换类
 	template <> class codecvtor<charset::utf32, charset::widechar> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于UTF-32转换成UTF-8的编码转换类
 	template <> class codecvtor<charset::utf32, charset::utf8> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// 用于UTF-32转换成UTF-16的编码转换类
 	template <> class codecvtor<charset::utf32, charset::utf16> : public codecvtor_base
 	{
 	public:
-		EXTIOSAPI codecvtor(void);
+		// 构造编码转换对象
+		// 参数: policy 遇到无效字符时的处理方式
+		EXTIOSAPI explicit codecvtor(error_policy policy = error_policy::throw_exception);
 	};
 
 	// UTF-8转换成本地字符集
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_multibyte_buffer(const char *s, unsigned int n);
+	EXTIOSAPI std::vector<char> to_multibyte_buffer(const char *s, std::size_t n);
 
 	// UTF-8转换成本地字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_multibyte_buffer(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char> to_multibyte_buffer(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const char *s, std::size_t n);
 
 	// UTF-8转换成本地字符集
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_multibyte_buffer(const std::string &text);
 
@@ -231,31 +293,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_multibyte_buffer(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const std::string &text);
 
 	// UTF-8转换成本地字符集
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_multibyte(const char *s, unsigned int n);
+	EXTIOSAPI std::string to_multibyte(const char *s, std::size_t n);
 
 	// UTF-8转换成本地字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_multibyte(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::string to_multibyte(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const char *s, std::size_t n);
 
 	// UTF-8转换成本地字符集
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_multibyte(const std::string &text);
 
@@ -263,31 +321,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_multibyte(const codecvtor<charset::utf8, charset::multibyte> &cvtor, const std::string &text);
 
 	// 宽字符字符集转换成本地字符集
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_multibyte_buffer(const wchar_t *s, unsigned int n);
+	EXTIOSAPI std::vector<char> to_multibyte_buffer(const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成本地字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_multibyte_buffer(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const wchar_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char> to_multibyte_buffer(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成本地字符集
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_multibyte_buffer(const std::wstring &text);
 
@@ -295,31 +349,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_multibyte_buffer(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const std::wstring &text);
 
 	// 宽字符字符集转换成本地字符集
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_multibyte(const wchar_t *s, unsigned int n);
+	EXTIOSAPI std::string to_multibyte(const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成本地字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_multibyte(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const wchar_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::string to_multibyte(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成本地字符集
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_multibyte(const std::wstring &text);
 
@@ -327,31 +377,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_multibyte(const codecvtor<charset::widechar, charset::multibyte> &cvtor, const std::wstring &text);
 
 	// UTF-16转换成本地字符集
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_multibyte_buffer(const char16_t *s, unsigned int n);
+	EXTIOSAPI std::vector<char> to_multibyte_buffer(const char16_t *s, std::size_t n);
 
 	// UTF-16转换成本地字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_multibyte_buffer(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const char16_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char> to_multibyte_buffer(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const char16_t *s, std::size_t n);
 
 	// UTF-16转换成本地字符集
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_multibyte_buffer(const std::u16string &text);
 
@@ -359,31 +405,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_multibyte_buffer(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const std::u16string &text);
 
 	// UTF-16转换成本地字符集
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_multibyte(const char16_t *s, unsigned int n);
+	EXTIOSAPI std::string to_multibyte(const char16_t *s, std::size_t n);
 
 	// UTF-16转换成本地字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_multibyte(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const char16_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::string to_multibyte(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const char16_t *s, std::size_t n);
 
 	// UTF-16转换成本地字符集
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_multibyte(const std::u16string &text);
 
@@ -391,31 +433,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_multibyte(const codecvtor<charset::utf16, charset::multibyte> &cvtor, const std::u16string &text);
 
 	// UTF-32转换成本地字符集
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_multibyte_buffer(const char32_t *s, unsigned int n);
+	EXTIOSAPI std::vector<char> to_multibyte_buffer(const char32_t *s, std::size_t n);
 
 	// UTF-32转换成本地字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_multibyte_buffer(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const char32_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char> to_multibyte_buffer(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const char32_t *s, std::size_t n);
 
 	// UTF-32转换成本地字符集
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_multibyte_buffer(const std::u32string &text);
 
@@ -423,31 +461,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_multibyte_buffer(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const std::u32string &text);
 
 	// UTF-32转换成本地字符集
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_multibyte(const char32_t *s, unsigned int n);
+	EXTIOSAPI std::string to_multibyte(const char32_t *s, std::size_t n);
 
 	// UTF-32转换成本地字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_multibyte(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const char32_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::string to_multibyte(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const char32_t *s, std::size_t n);
 
 	// UTF-32转换成本地字符集
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_multibyte(const std::u32string &text);
 
@@ -455,8 +489,7 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 本地字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_multibyte(const codecvtor<charset::utf32, charset::multibyte> &cvtor, const std::u32string &text);
 
 	// 本地字符集或UTF-8转换成宽字符字符集
@@ -464,33 +497,39 @@ namespace extios
 	// 参数: n 字符串的字节数
 	// 参数: isutf8 true代表传入字符串是UTF-8, false代表本地字符集
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const char *s, unsigned int n, bool isutf8);
+	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const char *s, std::size_t n, bool isutf8);
 
 	// 本地字符集转换成宽字符字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const char *s, std::size_t n);
 
 	// UTF-8转换成宽字符字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, std::size_t n);
+
+	// UTF-8转换成宽字符字符集, 输入数据在字符边界处分段后由多个线程同时转换
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: threads 最多使用的线程数, 为0时使用硬件支持的并发线程数, 输入数据较少时使用的线程更少
+	// 返回值: 宽字符字符集编码的字符串缓冲
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	// 异常: std::system_error 创建线程失败时抛出异常
+	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, std::size_t n, unsigned int threads);
 
 	// 本地字符集或UTF-8转换成宽字符字符集
 	// 参数: text 字符串对象
 	// 参数: isutf8 true代表传入字符串是UTF-8, false代表本地字符集
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const std::string &text, bool isutf8);
 
@@ -498,16 +537,14 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const std::string &text);
 
 	// UTF-8转换成宽字符字符集
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::utf8, charset::widechar> &cvtor, const std::string &text);
 
 	// 本地字符集或UTF-8转换成宽字符字符集
@@ -515,33 +552,29 @@ namespace extios
 	// 参数: n 字符串的字节数
 	// 参数: isutf8 true代表传入字符串是UTF-8, false代表本地字符集
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::wstring to_widechar(const char *s, unsigned int n, bool isutf8);
+	EXTIOSAPI std::wstring to_widechar(const char *s, std::size_t n, bool isutf8);
 
 	// 本地字符集转换成宽字符字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::wstring to_widechar(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::wstring to_widechar(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const char *s, std::size_t n);
 
 	// UTF-8转换成宽字符字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::wstring to_widechar(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::wstring to_widechar(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, std::size_t n);
 
 	// 本地字符集或UTF-8转换成宽字符字符集
 	// 参数: text 字符串对象
 	// 参数: isutf8 true代表传入字符串是UTF-8, false代表本地字符集
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::wstring to_widechar(const std::string &text, bool isutf8);
 
@@ -549,39 +582,44 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::wstring to_widechar(const codecvtor<charset::multibyte, charset::widechar> &cvtor, const std::string &text);
 
 	// UTF-8转换成宽字符字符集
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::wstring to_widechar(const codecvtor<charset::utf8, charset::widechar> &cvtor, const std::string &text);
 
 	// UTF-16转换成宽字符字符集
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const char16_t *s, unsigned int n);
+	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const char16_t *s, std::size_t n);
 
 	// UTF-16转换成宽字符字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, std::size_t n);
+
+	// UTF-16转换成宽字符字符集, 输入数据在字符边界处分段后由多个线程同时转换
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: threads 最多使用的线程数, 为0时使用硬件支持的并发线程数, 输入数据较少时使用的线程更少
+	// 返回值: 宽字符字符集编码的字符串缓冲
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	// 异常: std::system_error 创建线程失败时抛出异常
+	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, std::size_t n, unsigned int threads);
 
 	// UTF-16转换成宽字符字符集
 	// 参数: text 字符串对象
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const std::u16string &text);
 
@@ -589,31 +627,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::utf16, charset::widechar> &cvtor, const std::u16string &text);
 
 	// UTF-16转换成宽字符字符集
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::wstring to_widechar(const char16_t *s, unsigned int n);
+	EXTIOSAPI std::wstring to_widechar(const char16_t *s, std::size_t n);
 
 	// UTF-16转换成宽字符字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::wstring to_widechar(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::wstring to_widechar(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, std::size_t n);
 
 	// UTF-16转换成宽字符字符集
 	// 参数: text 字符串对象
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::wstring to_widechar(const std::u16string &text);
 
@@ -621,31 +655,37 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::wstring to_widechar(const codecvtor<charset::utf16, charset::widechar> &cvtor, const std::u16string &text);
 
 	// UTF-32转换成宽字符字符集
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const char32_t *s, unsigned int n);
+	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const char32_t *s, std::size_t n);
 
 	// UTF-32转换成宽字符字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, std::size_t n);
+
+	// UTF-32转换成宽字符字符集, 输入数据在字符边界处分段后由多个线程同时转换
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: threads 最多使用的线程数, 为0时使用硬件支持的并发线程数, 输入数据较少时使用的线程更少
+	// 返回值: 宽字符字符集编码的字符串缓冲
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	// 异常: std::system_error 创建线程失败时抛出异常
+	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, std::size_t n, unsigned int threads);
 
 	// UTF-32转换成宽字符字符集
 	// 参数: text 字符串对象
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const std::u32string &text);
 
@@ -653,31 +693,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 宽字符字符集编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<wchar_t> to_widechar_buffer(const codecvtor<charset::utf32, charset::widechar> &cvtor, const std::u32string &text);
 
 	// UTF-32转换成宽字符字符集
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::wstring to_widechar(const char32_t *s, unsigned int n);
+	EXTIOSAPI std::wstring to_widechar(const char32_t *s, std::size_t n);
 
 	// UTF-32转换成宽字符字符集
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::wstring to_widechar(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::wstring to_widechar(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, std::size_t n);
 
 	// UTF-32转换成宽字符字符集
 	// 参数: text 字符串对象
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::wstring to_widechar(const std::u32string &text);
 
@@ -685,31 +721,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: 宽字符字符集编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::wstring to_widechar(const codecvtor<charset::utf32, charset::widechar> &cvtor, const std::u32string &text);
 
 	// 本地字符集转换成UTF-8
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_utf8_buffer(const char *s, unsigned int n);
+	EXTIOSAPI std::vector<char> to_utf8_buffer(const char *s, std::size_t n);
 
 	// 本地字符集转换成UTF-8
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const char *s, std::size_t n);
 
 	// 本地字符集转换成UTF-8
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_utf8_buffer(const std::string &text);
 
@@ -717,31 +749,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const std::string &text);
 
 	// 本地字符集转换成UTF-8
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_utf8(const char *s, unsigned int n);
+	EXTIOSAPI std::string to_utf8(const char *s, std::size_t n);
 
 	// 本地字符集转换成UTF-8
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_utf8(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::string to_utf8(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const char *s, std::size_t n);
 
 	// 本地字符集转换成UTF-8
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_utf8(const std::string &text);
 
@@ -749,31 +777,37 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_utf8(const codecvtor<charset::multibyte, charset::utf8> &cvtor, const std::string &text);
 
 	// 宽字符字符集转换成UTF-8
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_utf8_buffer(const wchar_t *s, unsigned int n);
+	EXTIOSAPI std::vector<char> to_utf8_buffer(const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成UTF-8
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, std::size_t n);
+
+	// 宽字符字符集转换成UTF-8, 输入数据在字符边界处分段后由多个线程同时转换
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: threads 最多使用的线程数, 为0时使用硬件支持的并发线程数, 输入数据较少时使用的线程更少
+	// 返回值: UTF-8编码的字符串缓冲
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	// 异常: std::system_error 创建线程失败时抛出异常
+	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, std::size_t n, unsigned int threads);
 
 	// 宽字符字符集转换成UTF-8
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_utf8_buffer(const std::wstring &text);
 
@@ -781,31 +815,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::widechar, charset::utf8> &cvtor, const std::wstring &text);
 
 	// 宽字符字符集转换成UTF-8
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_utf8(const wchar_t *s, unsigned int n);
+	EXTIOSAPI std::string to_utf8(const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成UTF-8
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_utf8(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::string to_utf8(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成UTF-8
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_utf8(const std::wstring &text);
 
@@ -813,31 +843,37 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_utf8(const codecvtor<charset::widechar, charset::utf8> &cvtor, const std::wstring &text);
 
 	// UTF-16转换成UTF-8
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_utf8_buffer(const char16_t *s, unsigned int n);
+	EXTIOSAPI std::vector<char> to_utf8_buffer(const char16_t *s, std::size_t n);
 
 	// UTF-16转换成UTF-8
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, std::size_t n);
+
+	// UTF-16转换成UTF-8, 输入数据在字符边界处分段后由多个线程同时转换
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: threads 最多使用的线程数, 为0时使用硬件支持的并发线程数, 输入数据较少时使用的线程更少
+	// 返回值: UTF-8编码的字符串缓冲
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	// 异常: std::system_error 创建线程失败时抛出异常
+	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, std::size_t n, unsigned int threads);
 
 	// UTF-16转换成UTF-8
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_utf8_buffer(const std::u16string &text);
 
@@ -845,31 +881,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::utf16, charset::utf8> &cvtor, const std::u16string &text);
 
 	// UTF-16转换成UTF-8
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_utf8(const char16_t *s, unsigned int n);
+	EXTIOSAPI std::string to_utf8(const char16_t *s, std::size_t n);
 
 	// UTF-16转换成UTF-8
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_utf8(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::string to_utf8(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, std::size_t n);
 
 	// UTF-16转换成UTF-8
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_utf8(const std::u16string &text);
 
@@ -877,31 +909,37 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_utf8(const codecvtor<charset::utf16, charset::utf8> &cvtor, const std::u16string &text);
 
 	// UTF-32转换成UTF-8
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_utf8_buffer(const char32_t *s, unsigned int n);
+	EXTIOSAPI std::vector<char> to_utf8_buffer(const char32_t *s, std::size_t n);
 
 	// UTF-32转换成UTF-8
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, std::size_t n);
+
+	// UTF-32转换成UTF-8, 输入数据在字符边界处分段后由多个线程同时转换
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: threads 最多使用的线程数, 为0时使用硬件支持的并发线程数, 输入数据较少时使用的线程更少
+	// 返回值: UTF-8编码的字符串缓冲
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	// 异常: std::system_error 创建线程失败时抛出异常
+	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, std::size_t n, unsigned int threads);
 
 	// UTF-32转换成UTF-8
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_utf8_buffer(const std::u32string &text);
 
@@ -909,31 +947,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char> to_utf8_buffer(const codecvtor<charset::utf32, charset::utf8> &cvtor, const std::u32string &text);
 
 	// UTF-32转换成UTF-8
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_utf8(const char32_t *s, unsigned int n);
+	EXTIOSAPI std::string to_utf8(const char32_t *s, std::size_t n);
 
 	// UTF-32转换成UTF-8
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::string to_utf8(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::string to_utf8(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, std::size_t n);
 
 	// UTF-32转换成UTF-8
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_utf8(const std::u32string &text);
 
@@ -941,8 +975,7 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-8编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::string to_utf8(const codecvtor<charset::utf32, charset::utf8> &cvtor, const std::u32string &text);
 
 	// 本地字符集或UTF-8转换成UTF-16
@@ -950,33 +983,39 @@ namespace extios
 	// 参数: n 字符串的字节数
 	// 参数: isutf8 true代表传入字符串是UTF-8, false代表本地字符集
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const char *s, unsigned int n, bool isutf8);
+	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const char *s, std::size_t n, bool isutf8);
 
 	// 本地字符集转换成UTF-16
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const char *s, std::size_t n);
 
 	// UTF-8转换成UTF-16
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, std::size_t n);
+
+	// UTF-8转换成UTF-16, 输入数据在字符边界处分段后由多个线程同时转换
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: threads 最多使用的线程数, 为0时使用硬件支持的并发线程数, 输入数据较少时使用的线程更少
+	// 返回值: UTF-16编码的字符串缓冲
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	// 异常: std::system_error 创建线程失败时抛出异常
+	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, std::size_t n, unsigned int threads);
 
 	// 本地字符集或UTF-8转换成UTF-16
 	// 参数: text 字符串对象
 	// 参数: isutf8 true代表传入字符串是UTF-8, false代表本地字符集
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const std::string &text, bool isutf8);
 
@@ -984,16 +1023,14 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const std::string &text);
 
 	// UTF-8转换成UTF-16
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::utf8, charset::utf16> &cvtor, const std::string &text);
 
 	// 本地字符集或UTF-8转换成UTF-16
@@ -1001,33 +1038,29 @@ namespace extios
 	// 参数: n 字符串的字节数
 	// 参数: isutf8 true代表传入字符串是UTF-8, false代表本地字符集
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u16string to_utf16(const char *s, unsigned int n, bool isutf8);
+	EXTIOSAPI std::u16string to_utf16(const char *s, std::size_t n, bool isutf8);
 
 	// 本地字符集转换成UTF-16
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u16string to_utf16(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::u16string to_utf16(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const char *s, std::size_t n);
 
 	// UTF-8转换成UTF-16
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u16string to_utf16(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::u16string to_utf16(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, std::size_t n);
 
 	// 本地字符集或UTF-8转换成UTF-16
 	// 参数: text 字符串对象
 	// 参数: isutf8 true代表传入字符串是UTF-8, false代表本地字符集
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u16string to_utf16(const std::string &text, bool isutf8);
 
@@ -1035,39 +1068,44 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u16string to_utf16(const codecvtor<charset::multibyte, charset::utf16> &cvtor, const std::string &text);
 
 	// UTF-8转换成UTF-16
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u16string to_utf16(const codecvtor<charset::utf8, charset::utf16> &cvtor, const std::string &text);
 
 	// 宽字符字符集转换成UTF-16
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const wchar_t *s, unsigned int n);
+	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成UTF-16
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, std::size_t n);
+
+	// 宽字符字符集转换成UTF-16, 输入数据在字符边界处分段后由多个线程同时转换
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: threads 最多使用的线程数, 为0时使用硬件支持的并发线程数, 输入数据较少时使用的线程更少
+	// 返回值: UTF-16编码的字符串缓冲
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	// 异常: std::system_error 创建线程失败时抛出异常
+	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, std::size_t n, unsigned int threads);
 
 	// 宽字符字符集转换成UTF-16
 	// 参数: text 字符串对象
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const std::wstring &text);
 
@@ -1075,31 +1113,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::widechar, charset::utf16> &cvtor, const std::wstring &text);
 
 	// 宽字符字符集转换成UTF-16
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u16string to_utf16(const wchar_t *s, unsigned int n);
+	EXTIOSAPI std::u16string to_utf16(const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成UTF-16
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u16string to_utf16(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::u16string to_utf16(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成UTF-16
 	// 参数: text 字符串对象
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u16string to_utf16(const std::wstring &text);
 
@@ -1107,31 +1141,37 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u16string to_utf16(const codecvtor<charset::widechar, charset::utf16> &cvtor, const std::wstring &text);
 	
 	// UTF-32转换成UTF-16
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const char32_t *s, unsigned int n);
+	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const char32_t *s, std::size_t n);
 
 	// UTF-32转换成UTF-16
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, std::size_t n);
+
+	// UTF-32转换成UTF-16, 输入数据在字符边界处分段后由多个线程同时转换
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: threads 最多使用的线程数, 为0时使用硬件支持的并发线程数, 输入数据较少时使用的线程更少
+	// 返回值: UTF-16编码的字符串缓冲
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	// 异常: std::system_error 创建线程失败时抛出异常
+	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, std::size_t n, unsigned int threads);
 
 	// UTF-32转换成UTF-16
 	// 参数: text 字符串对象
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const std::u32string &text);
 
@@ -1139,31 +1179,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-16编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char16_t> to_utf16_buffer(const codecvtor<charset::utf32, charset::utf16> &cvtor, const std::u32string &text);
 
 	// UTF-32转换成UTF-16
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u16string to_utf16(const char32_t *s, unsigned int n);
+	EXTIOSAPI std::u16string to_utf16(const char32_t *s, std::size_t n);
 
 	// UTF-32转换成UTF-16
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u16string to_utf16(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::u16string to_utf16(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, std::size_t n);
 
 	// UTF-32转换成UTF-16
 	// 参数: text 字符串对象
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u16string to_utf16(const std::u32string &text);
 
@@ -1171,8 +1207,7 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-16编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u16string to_utf16(const codecvtor<charset::utf32, charset::utf16> &cvtor, const std::u32string &text);
 
 	// 本地字符集或UTF-8转换成UTF-32
@@ -1180,33 +1215,39 @@ namespace extios
 	// 参数: n 字符串的字节数
 	// 参数: isutf8 true代表传入字符串是UTF-8, false代表本地字符集
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const char *s, unsigned int n, bool isutf8);
+	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const char *s, std::size_t n, bool isutf8);
 
 	// 本地字符集转换成UTF-32
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const char *s, std::size_t n);
 
 	// UTF-8转换成UTF-32
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, std::size_t n);
+
+	// UTF-8转换成UTF-32, 输入数据在字符边界处分段后由多个线程同时转换
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: threads 最多使用的线程数, 为0时使用硬件支持的并发线程数, 输入数据较少时使用的线程更少
+	// 返回值: UTF-32编码的字符串缓冲
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	// 异常: std::system_error 创建线程失败时抛出异常
+	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, std::size_t n, unsigned int threads);
 
 	// 本地字符集或UTF-8转换成UTF-32
 	// 参数: text 字符串对象
 	// 参数: isutf8 true代表传入字符串是UTF-8, false代表本地字符集
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const std::string &text, bool isutf8);
 
@@ -1214,16 +1255,14 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const std::string &text);
 
 	// UTF-8转换成UTF-32
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::utf8, charset::utf32> &cvtor, const std::string &text);
 
 	// 本地字符集或UTF-8转换成UTF-32
@@ -1231,33 +1270,29 @@ namespace extios
 	// 参数: n 字符串的字节数
 	// 参数: isutf8 true代表传入字符串是UTF-8, false代表本地字符集
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u32string to_utf32(const char *s, unsigned int n, bool isutf8);
+	EXTIOSAPI std::u32string to_utf32(const char *s, std::size_t n, bool isutf8);
 
 	// 本地字符集转换成UTF-32
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u32string to_utf32(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::u32string to_utf32(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const char *s, std::size_t n);
 
 	// UTF-8转换成UTF-32
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字节数
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u32string to_utf32(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::u32string to_utf32(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, std::size_t n);
 
 	// 本地字符集或UTF-8转换成UTF-32
 	// 参数: text 字符串对象
 	// 参数: isutf8 true代表传入字符串是UTF-8, false代表本地字符集
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u32string to_utf32(const std::string &text, bool isutf8);
 
@@ -1265,39 +1300,44 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u32string to_utf32(const codecvtor<charset::multibyte, charset::utf32> &cvtor, const std::string &text);
 
 	// UTF-8转换成UTF-32
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u32string to_utf32(const codecvtor<charset::utf8, charset::utf32> &cvtor, const std::string &text);
 
 	// 宽字符字符集转换成UTF-32
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const wchar_t *s, unsigned int n);
+	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成UTF-32
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, std::size_t n);
+
+	// 宽字符字符集转换成UTF-32, 输入数据在字符边界处分段后由多个线程同时转换
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: threads 最多使用的线程数, 为0时使用硬件支持的并发线程数, 输入数据较少时使用的线程更少
+	// 返回值: UTF-32编码的字符串缓冲
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	// 异常: std::system_error 创建线程失败时抛出异常
+	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, std::size_t n, unsigned int threads);
 
 	// 宽字符字符集转换成UTF-32
 	// 参数: text 字符串对象
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const std::wstring &text);
 
@@ -1305,31 +1345,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::widechar, charset::utf32> &cvtor, const std::wstring &text);
 
 	// 宽字符字符集转换成UTF-32
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u32string to_utf32(const wchar_t *s, unsigned int n);
+	EXTIOSAPI std::u32string to_utf32(const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成UTF-32
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u32string to_utf32(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::u32string to_utf32(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, std::size_t n);
 
 	// 宽字符字符集转换成UTF-32
 	// 参数: text 字符串对象
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u32string to_utf32(const std::wstring &text);
 
@@ -1337,31 +1373,37 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u32string to_utf32(const codecvtor<charset::widechar, charset::utf32> &cvtor, const std::wstring &text);
 
 	// UTF-16转换成UTF-32
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const char16_t *s, unsigned int n);
+	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const char16_t *s, std::size_t n);
 
 	// UTF-16转换成UTF-32
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, std::size_t n);
+
+	// UTF-16转换成UTF-32, 输入数据在字符边界处分段后由多个线程同时转换
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: threads 最多使用的线程数, 为0时使用硬件支持的并发线程数, 输入数据较少时使用的线程更少
+	// 返回值: UTF-32编码的字符串缓冲
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	// 异常: std::system_error 创建线程失败时抛出异常
+	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, std::size_t n, unsigned int threads);
 
 	// UTF-16转换成UTF-32
 	// 参数: text 字符串对象
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const std::u16string &text);
 
@@ -1369,31 +1411,27 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-32编码的字符串缓冲
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::vector<char32_t> to_utf32_buffer(const codecvtor<charset::utf16, charset::utf32> &cvtor, const std::u16string &text);
 
 	// UTF-16转换成UTF-32
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u32string to_utf32(const char16_t *s, unsigned int n);
+	EXTIOSAPI std::u32string to_utf32(const char16_t *s, std::size_t n);
 
 	// UTF-16转换成UTF-32
 	// 参数: cvtor 转换类对象
 	// 参数: s 字符串首地址
 	// 参数: n 字符串的字符数
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
-	EXTIOSAPI std::u32string to_utf32(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, unsigned int n);
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI std::u32string to_utf32(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, std::size_t n);
 
 	// UTF-16转换成UTF-32
 	// 参数: text 字符串对象
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
 	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u32string to_utf32(const std::u16string &text);
 
@@ -1401,9 +1439,648 @@ namespace extios
 	// 参数: cvtor 转换类对象
 	// 参数: text 字符串对象
 	// 返回值: UTF-32编码的字符串
-	// 异常: std::length_error 需要转换编码的字符串过长
-	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当输入数据不是有效的字符串时抛出异常
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
 	EXTIOSAPI std::u32string to_utf32(const codecvtor<charset::utf16, charset::utf32> &cvtor, const std::u16string &text);
+
+	// 输出到调用者提供的空间时的转换结果
+	struct convert_result
+	{
+		std::size_t consumed; // 已转换的输入数据长度
+		std::size_t written; // 已输出的数据长度
+	};
+
+	// 宽字符字符集转换成UTF-8, 输出到调用者提供的空间
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字节数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const wchar_t *s, std::size_t n, char *dest, std::size_t capacity);
+
+	// 宽字符字符集转换成UTF-8, 输出到调用者提供的空间
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字节数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, std::size_t n, char *dest, std::size_t capacity);
+
+	// 宽字符字符集转换成UTF-16, 输出到调用者提供的空间
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const wchar_t *s, std::size_t n, char16_t *dest, std::size_t capacity);
+
+	// 宽字符字符集转换成UTF-16, 输出到调用者提供的空间
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, std::size_t n, char16_t *dest, std::size_t capacity);
+
+	// 宽字符字符集转换成UTF-32, 输出到调用者提供的空间
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const wchar_t *s, std::size_t n, char32_t *dest, std::size_t capacity);
+
+	// 宽字符字符集转换成UTF-32, 输出到调用者提供的空间
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, std::size_t n, char32_t *dest, std::size_t capacity);
+
+	// UTF-8转换成宽字符字符集, 输出到调用者提供的空间
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const char *s, std::size_t n, wchar_t *dest, std::size_t capacity);
+
+	// UTF-8转换成宽字符字符集, 输出到调用者提供的空间
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, std::size_t n, wchar_t *dest, std::size_t capacity);
+
+	// UTF-8转换成UTF-16, 输出到调用者提供的空间
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const char *s, std::size_t n, char16_t *dest, std::size_t capacity);
+
+	// UTF-8转换成UTF-16, 输出到调用者提供的空间
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, std::size_t n, char16_t *dest, std::size_t capacity);
+
+	// UTF-8转换成UTF-32, 输出到调用者提供的空间
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const char *s, std::size_t n, char32_t *dest, std::size_t capacity);
+
+	// UTF-8转换成UTF-32, 输出到调用者提供的空间
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, std::size_t n, char32_t *dest, std::size_t capacity);
+
+	// UTF-16转换成宽字符字符集, 输出到调用者提供的空间
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const char16_t *s, std::size_t n, wchar_t *dest, std::size_t capacity);
+
+	// UTF-16转换成宽字符字符集, 输出到调用者提供的空间
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, std::size_t n, wchar_t *dest, std::size_t capacity);
+
+	// UTF-16转换成UTF-8, 输出到调用者提供的空间
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字节数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const char16_t *s, std::size_t n, char *dest, std::size_t capacity);
+
+	// UTF-16转换成UTF-8, 输出到调用者提供的空间
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字节数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, std::size_t n, char *dest, std::size_t capacity);
+
+	// UTF-16转换成UTF-32, 输出到调用者提供的空间
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const char16_t *s, std::size_t n, char32_t *dest, std::size_t capacity);
+
+	// UTF-16转换成UTF-32, 输出到调用者提供的空间
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, std::size_t n, char32_t *dest, std::size_t capacity);
+
+	// UTF-32转换成宽字符字符集, 输出到调用者提供的空间
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const char32_t *s, std::size_t n, wchar_t *dest, std::size_t capacity);
+
+	// UTF-32转换成宽字符字符集, 输出到调用者提供的空间
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, std::size_t n, wchar_t *dest, std::size_t capacity);
+
+	// UTF-32转换成UTF-8, 输出到调用者提供的空间
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字节数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const char32_t *s, std::size_t n, char *dest, std::size_t capacity);
+
+	// UTF-32转换成UTF-8, 输出到调用者提供的空间
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字节数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, std::size_t n, char *dest, std::size_t capacity);
+
+	// UTF-32转换成UTF-16, 输出到调用者提供的空间
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const char32_t *s, std::size_t n, char16_t *dest, std::size_t capacity);
+
+	// UTF-32转换成UTF-16, 输出到调用者提供的空间
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 已转换的输入数据长度和已输出的数据长度, 输出空间不足时只转换能容纳的完整字符
+	// 异常: std::invalid_argument 当cvtor是空对象时抛出异常或者当cvtor的处理方式是throw_exception且输入数据不是有效的字符串时抛出异常
+	EXTIOSAPI convert_result convert_into(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, std::size_t n, char16_t *dest, std::size_t capacity);
+
+	// 不抛出异常的转换结束的原因
+	enum class convert_status
+	{
+		ok, // 全部输入都已转换
+		invalid_input, // 遇到无效的字符
+		incomplete_input, // 输入数据末尾的字符不完整, 补充后续数据后可能有效
+		insufficient_output, // 输出空间不足以容纳下一个字符
+		null_convertor // 转换类对象是空对象
+	};
+
+	// 不抛出异常的转换结果
+	struct try_convert_result
+	{
+		static constexpr std::size_t no_error = static_cast<std::size_t>(-1);
+
+		convert_status status; // 转换结束的原因
+		std::size_t consumed; // 已转换的输入数据长度
+		std::size_t written; // 已输出的数据长度
+		std::size_t error_position; // 无效或不完整的字符在输入数据中的位置, 没有时为no_error
+	};
+
+	// 宽字符字符集转换成UTF-8, 输出到调用者提供的空间, 不抛出异常
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字节数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 遇到无效的字符或输出空间不足时停止
+	EXTIOSAPI try_convert_result try_convert_into(const wchar_t *s, std::size_t n, char *dest, std::size_t capacity) noexcept;
+
+	// 宽字符字符集转换成UTF-8, 输出到调用者提供的空间, 不抛出异常
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字节数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 输出空间不足时停止
+	//         按照cvtor的处理方式处理无效的字符, 替换或丢弃时error_position是第一个无效字符的位置
+	//         末尾不完整的字符不做替换或丢弃, 返回convert_status::incomplete_input
+	//         cvtor是空对象时返回convert_status::null_convertor
+	EXTIOSAPI try_convert_result try_convert_into(const codecvtor<charset::widechar, charset::utf8> &cvtor, const wchar_t *s, std::size_t n, char *dest, std::size_t capacity) noexcept;
+
+	// 宽字符字符集转换成UTF-16, 输出到调用者提供的空间, 不抛出异常
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 遇到无效的字符或输出空间不足时停止
+	EXTIOSAPI try_convert_result try_convert_into(const wchar_t *s, std::size_t n, char16_t *dest, std::size_t capacity) noexcept;
+
+	// 宽字符字符集转换成UTF-16, 输出到调用者提供的空间, 不抛出异常
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 输出空间不足时停止
+	//         按照cvtor的处理方式处理无效的字符, 替换或丢弃时error_position是第一个无效字符的位置
+	//         末尾不完整的字符不做替换或丢弃, 返回convert_status::incomplete_input
+	//         cvtor是空对象时返回convert_status::null_convertor
+	EXTIOSAPI try_convert_result try_convert_into(const codecvtor<charset::widechar, charset::utf16> &cvtor, const wchar_t *s, std::size_t n, char16_t *dest, std::size_t capacity) noexcept;
+
+	// 宽字符字符集转换成UTF-32, 输出到调用者提供的空间, 不抛出异常
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 遇到无效的字符或输出空间不足时停止
+	EXTIOSAPI try_convert_result try_convert_into(const wchar_t *s, std::size_t n, char32_t *dest, std::size_t capacity) noexcept;
+
+	// 宽字符字符集转换成UTF-32, 输出到调用者提供的空间, 不抛出异常
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 输出空间不足时停止
+	//         按照cvtor的处理方式处理无效的字符, 替换或丢弃时error_position是第一个无效字符的位置
+	//         末尾不完整的字符不做替换或丢弃, 返回convert_status::incomplete_input
+	//         cvtor是空对象时返回convert_status::null_convertor
+	EXTIOSAPI try_convert_result try_convert_into(const codecvtor<charset::widechar, charset::utf32> &cvtor, const wchar_t *s, std::size_t n, char32_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-8转换成宽字符字符集, 输出到调用者提供的空间, 不抛出异常
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 遇到无效的字符或输出空间不足时停止
+	EXTIOSAPI try_convert_result try_convert_into(const char *s, std::size_t n, wchar_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-8转换成宽字符字符集, 输出到调用者提供的空间, 不抛出异常
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 输出空间不足时停止
+	//         按照cvtor的处理方式处理无效的字符, 替换或丢弃时error_position是第一个无效字符的位置
+	//         末尾不完整的字符不做替换或丢弃, 返回convert_status::incomplete_input
+	//         cvtor是空对象时返回convert_status::null_convertor
+	EXTIOSAPI try_convert_result try_convert_into(const codecvtor<charset::utf8, charset::widechar> &cvtor, const char *s, std::size_t n, wchar_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-8转换成UTF-16, 输出到调用者提供的空间, 不抛出异常
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 遇到无效的字符或输出空间不足时停止
+	EXTIOSAPI try_convert_result try_convert_into(const char *s, std::size_t n, char16_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-8转换成UTF-16, 输出到调用者提供的空间, 不抛出异常
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 输出空间不足时停止
+	//         按照cvtor的处理方式处理无效的字符, 替换或丢弃时error_position是第一个无效字符的位置
+	//         末尾不完整的字符不做替换或丢弃, 返回convert_status::incomplete_input
+	//         cvtor是空对象时返回convert_status::null_convertor
+	EXTIOSAPI try_convert_result try_convert_into(const codecvtor<charset::utf8, charset::utf16> &cvtor, const char *s, std::size_t n, char16_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-8转换成UTF-32, 输出到调用者提供的空间, 不抛出异常
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 遇到无效的字符或输出空间不足时停止
+	EXTIOSAPI try_convert_result try_convert_into(const char *s, std::size_t n, char32_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-8转换成UTF-32, 输出到调用者提供的空间, 不抛出异常
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 输出空间不足时停止
+	//         按照cvtor的处理方式处理无效的字符, 替换或丢弃时error_position是第一个无效字符的位置
+	//         末尾不完整的字符不做替换或丢弃, 返回convert_status::incomplete_input
+	//         cvtor是空对象时返回convert_status::null_convertor
+	EXTIOSAPI try_convert_result try_convert_into(const codecvtor<charset::utf8, charset::utf32> &cvtor, const char *s, std::size_t n, char32_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-16转换成宽字符字符集, 输出到调用者提供的空间, 不抛出异常
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 遇到无效的字符或输出空间不足时停止
+	EXTIOSAPI try_convert_result try_convert_into(const char16_t *s, std::size_t n, wchar_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-16转换成宽字符字符集, 输出到调用者提供的空间, 不抛出异常
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 输出空间不足时停止
+	//         按照cvtor的处理方式处理无效的字符, 替换或丢弃时error_position是第一个无效字符的位置
+	//         末尾不完整的字符不做替换或丢弃, 返回convert_status::incomplete_input
+	//         cvtor是空对象时返回convert_status::null_convertor
+	EXTIOSAPI try_convert_result try_convert_into(const codecvtor<charset::utf16, charset::widechar> &cvtor, const char16_t *s, std::size_t n, wchar_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-16转换成UTF-8, 输出到调用者提供的空间, 不抛出异常
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字节数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 遇到无效的字符或输出空间不足时停止
+	EXTIOSAPI try_convert_result try_convert_into(const char16_t *s, std::size_t n, char *dest, std::size_t capacity) noexcept;
+
+	// UTF-16转换成UTF-8, 输出到调用者提供的空间, 不抛出异常
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字节数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 输出空间不足时停止
+	//         按照cvtor的处理方式处理无效的字符, 替换或丢弃时error_position是第一个无效字符的位置
+	//         末尾不完整的字符不做替换或丢弃, 返回convert_status::incomplete_input
+	//         cvtor是空对象时返回convert_status::null_convertor
+	EXTIOSAPI try_convert_result try_convert_into(const codecvtor<charset::utf16, charset::utf8> &cvtor, const char16_t *s, std::size_t n, char *dest, std::size_t capacity) noexcept;
+
+	// UTF-16转换成UTF-32, 输出到调用者提供的空间, 不抛出异常
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 遇到无效的字符或输出空间不足时停止
+	EXTIOSAPI try_convert_result try_convert_into(const char16_t *s, std::size_t n, char32_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-16转换成UTF-32, 输出到调用者提供的空间, 不抛出异常
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 输出空间不足时停止
+	//         按照cvtor的处理方式处理无效的字符, 替换或丢弃时error_position是第一个无效字符的位置
+	//         末尾不完整的字符不做替换或丢弃, 返回convert_status::incomplete_input
+	//         cvtor是空对象时返回convert_status::null_convertor
+	EXTIOSAPI try_convert_result try_convert_into(const codecvtor<charset::utf16, charset::utf32> &cvtor, const char16_t *s, std::size_t n, char32_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-32转换成宽字符字符集, 输出到调用者提供的空间, 不抛出异常
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 遇到无效的字符或输出空间不足时停止
+	EXTIOSAPI try_convert_result try_convert_into(const char32_t *s, std::size_t n, wchar_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-32转换成宽字符字符集, 输出到调用者提供的空间, 不抛出异常
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 输出空间不足时停止
+	//         按照cvtor的处理方式处理无效的字符, 替换或丢弃时error_position是第一个无效字符的位置
+	//         末尾不完整的字符不做替换或丢弃, 返回convert_status::incomplete_input
+	//         cvtor是空对象时返回convert_status::null_convertor
+	EXTIOSAPI try_convert_result try_convert_into(const codecvtor<charset::utf32, charset::widechar> &cvtor, const char32_t *s, std::size_t n, wchar_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-32转换成UTF-8, 输出到调用者提供的空间, 不抛出异常
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字节数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 遇到无效的字符或输出空间不足时停止
+	EXTIOSAPI try_convert_result try_convert_into(const char32_t *s, std::size_t n, char *dest, std::size_t capacity) noexcept;
+
+	// UTF-32转换成UTF-8, 输出到调用者提供的空间, 不抛出异常
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字节数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 输出空间不足时停止
+	//         按照cvtor的处理方式处理无效的字符, 替换或丢弃时error_position是第一个无效字符的位置
+	//         末尾不完整的字符不做替换或丢弃, 返回convert_status::incomplete_input
+	//         cvtor是空对象时返回convert_status::null_convertor
+	EXTIOSAPI try_convert_result try_convert_into(const codecvtor<charset::utf32, charset::utf8> &cvtor, const char32_t *s, std::size_t n, char *dest, std::size_t capacity) noexcept;
+
+	// UTF-32转换成UTF-16, 输出到调用者提供的空间, 不抛出异常
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 遇到无效的字符或输出空间不足时停止
+	EXTIOSAPI try_convert_result try_convert_into(const char32_t *s, std::size_t n, char16_t *dest, std::size_t capacity) noexcept;
+
+	// UTF-32转换成UTF-16, 输出到调用者提供的空间, 不抛出异常
+	// 参数: cvtor 转换类对象
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字符数
+	// 参数: dest 输出位置
+	// 参数: capacity 输出空间的字符数
+	// 返回值: 转换结束的原因、已转换的输入数据长度、已输出的数据长度和出错位置, 输出空间不足时停止
+	//         按照cvtor的处理方式处理无效的字符, 替换或丢弃时error_position是第一个无效字符的位置
+	//         末尾不完整的字符不做替换或丢弃, 返回convert_status::incomplete_input
+	//         cvtor是空对象时返回convert_status::null_convertor
+	EXTIOSAPI try_convert_result try_convert_into(const codecvtor<charset::utf32, charset::utf16> &cvtor, const char32_t *s, std::size_t n, char16_t *dest, std::size_t capacity) noexcept;
+
+	// 文件从一种编码转换成另一种编码, 输入文件映射到内存后分块转换, 每转换一块以一次写入输出到输出文件
+	// 本地字符集不能分块转换, 输入或输出是本地字符集时整体转换后写出
+	// 宽字符、UTF-16、UTF-32文件使用本机字节序, 不读取也不写入BOM
+	// 输入和输出的字符集相同时也按照policy处理无效字符, 只有本地字符集之间原样复制
+	// 参数: path_in 输入文件路径, 不能映射到内存的文件(如管道)整体读入内存
+	// 参数: from 输入文件的字符集
+	// 参数: path_out 输出文件路径, 已存在时清空原有内容, 不能和输入文件相同
+	// 参数: to 输出文件的字符集
+	// 参数: policy 遇到无效字符时的处理方式, 输入文件末尾不足一个字符的字节也是无效字符, 按照policy在输出末尾替换或丢弃
+	// 参数: threads Unicode编码之间转换时最多使用的线程数, 为0时使用硬件支持的并发线程数, 不为1时整体转换后一次写出
+	// 返回值: 写入输出文件的字节数
+	// 异常: std::system_error 打开、读取、映射或写入文件失败, 或者创建线程失败时抛出异常
+	// 异常: std::invalid_argument 字符集无效、输入和输出是同一个文件, 或者policy是throw_exception且输入文件包含无效字符时抛出异常, 输出文件可能保留已经转换的部分
+	EXTIOSAPI std::uint64_t transcode_file(const char *path_in, charset from, const char *path_out, charset to, error_policy policy = error_policy::throw_exception, unsigned int threads = 1);
+
+	// 计算UTF-8转换成宽字符字符集后的字符数
+	// 参数: s 字符串首地址, 必须是有效的字符串, 否则返回值不准确
+	// 参数: n 字符串的字节数
+	// 返回值: 转换后的字符数, 不包括结尾的空字符
+	EXTIOSAPI std::size_t widechar_length_from_utf8(const char *s, std::size_t n) noexcept;
+
+	// 计算UTF-16转换成宽字符字符集后的字符数
+	// 参数: s 字符串首地址, 必须是有效的字符串, 否则返回值不准确
+	// 参数: n 字符串的字符数
+	// 返回值: 转换后的字符数, 不包括结尾的空字符
+	EXTIOSAPI std::size_t widechar_length_from_utf16(const char16_t *s, std::size_t n) noexcept;
+
+	// 计算UTF-32转换成宽字符字符集后的字符数
+	// 参数: s 字符串首地址, 必须是有效的字符串, 否则返回值不准确
+	// 参数: n 字符串的字符数
+	// 返回值: 转换后的字符数, 不包括结尾的空字符
+	EXTIOSAPI std::size_t widechar_length_from_utf32(const char32_t *s, std::size_t n) noexcept;
+
+	// 计算宽字符字符集转换成UTF-8后的字节数
+	// 参数: s 字符串首地址, 必须是有效的字符串, 否则返回值不准确
+	// 参数: n 字符串的字符数
+	// 返回值: 转换后的字节数, 不包括结尾的空字符
+	EXTIOSAPI std::size_t utf8_length_from_widechar(const wchar_t *s, std::size_t n) noexcept;
+
+	// 计算UTF-16转换成UTF-8后的字节数
+	// 参数: s 字符串首地址, 必须是有效的字符串, 否则返回值不准确
+	// 参数: n 字符串的字符数
+	// 返回值: 转换后的字节数, 不包括结尾的空字符
+	EXTIOSAPI std::size_t utf8_length_from_utf16(const char16_t *s, std::size_t n) noexcept;
+
+	// 计算UTF-32转换成UTF-8后的字节数
+	// 参数: s 字符串首地址, 必须是有效的字符串, 否则返回值不准确
+	// 参数: n 字符串的字符数
+	// 返回值: 转换后的字节数, 不包括结尾的空字符
+	EXTIOSAPI std::size_t utf8_length_from_utf32(const char32_t *s, std::size_t n) noexcept;
+
+	// 计算宽字符字符集转换成UTF-16后的字符数
+	// 参数: s 字符串首地址, 必须是有效的字符串, 否则返回值不准确
+	// 参数: n 字符串的字符数
+	// 返回值: 转换后的字符数, 不包括结尾的空字符
+	EXTIOSAPI std::size_t utf16_length_from_widechar(const wchar_t *s, std::size_t n) noexcept;
+
+	// 计算UTF-8转换成UTF-16后的字符数
+	// 参数: s 字符串首地址, 必须是有效的字符串, 否则返回值不准确
+	// 参数: n 字符串的字节数
+	// 返回值: 转换后的字符数, 不包括结尾的空字符
+	EXTIOSAPI std::size_t utf16_length_from_utf8(const char *s, std::size_t n) noexcept;
+
+	// 计算UTF-32转换成UTF-16后的字符数
+	// 参数: s 字符串首地址, 必须是有效的字符串, 否则返回值不准确
+	// 参数: n 字符串的字符数
+	// 返回值: 转换后的字符数, 不包括结尾的空字符
+	EXTIOSAPI std::size_t utf16_length_from_utf32(const char32_t *s, std::size_t n) noexcept;
+
+	// 计算宽字符字符集转换成UTF-32后的字符数
+	// 参数: s 字符串首地址, 必须是有效的字符串, 否则返回值不准确
+	// 参数: n 字符串的字符数
+	// 返回值: 转换后的字符数, 不包括结尾的空字符
+	EXTIOSAPI std::size_t utf32_length_from_widechar(const wchar_t *s, std::size_t n) noexcept;
+
+	// 计算UTF-8转换成UTF-32后的字符数
+	// 参数: s 字符串首地址, 必须是有效的字符串, 否则返回值不准确
+	// 参数: n 字符串的字节数
+	// 返回值: 转换后的字符数, 不包括结尾的空字符
+	EXTIOSAPI std::size_t utf32_length_from_utf8(const char *s, std::size_t n) noexcept;
+
+	// 计算UTF-16转换成UTF-32后的字符数
+	// 参数: s 字符串首地址, 必须是有效的字符串, 否则返回值不准确
+	// 参数: n 字符串的字符数
+	// 返回值: 转换后的字符数, 不包括结尾的空字符
+	EXTIOSAPI std::size_t utf32_length_from_utf16(const char16_t *s, std::size_t n) noexcept;
+
+	// 检查字符串是否是有效的UTF-8, 过长编码、代理码点、超过U+10FFFF的码点以及末尾不完整的字符都是无效的
+	// 参数: s 字符串首地址
+	// 参数: n 字符串的字节数
+	// 返回值: 有效返回true, 否则返回false
+	EXTIOSAPI bool is_valid_utf8(const char *s, std::size_t n) noexcept;
+
+	// 检查字符串是否是有效的UTF-8, 过长编码、代理码点、超过U+10FFFF的码点以及末尾不完整的字符都是无效的
+	// 参数: text 需要检查的字符串
+	// 返回值: 有效返回true, 否则返回false
+	EXTIOSAPI bool is_valid_utf8(const std::string &text) noexcept;
+
+	// 获取当前CPU支持的最快的Unicode编码转换实现
+	// 返回值: 最快的实现方式
+	EXTIOSAPI implementation best_implementation(void) noexcept;
+
+	// 获取正在使用的Unicode编码转换实现, 加载动态库时选择当前CPU支持的最快实现
+	// 返回值: 正在使用的实现方式
+	EXTIOSAPI implementation active_implementation(void) noexcept;
+
+	// 指定Unicode编码转换使用的实现, 对所有线程生效
+	// 参数: level 需要使用的实现方式
+	// 返回值: 成功返回true, 当前CPU不支持指定的实现时返回false并且不改变正在使用的实现
+	EXTIOSAPI bool set_implementation(implementation level) noexcept;
+
+	// 一种编码转换的统计计数
+	struct conversion_stats
+	{
+		std::uint64_t calls; // 调用次数, 包括抛出异常的调用
+		std::uint64_t input_units; // 输入的字符数, 输出到调用者提供的空间时是已转换的长度
+		std::uint64_t output_units; // 输出的字符数
+		std::uint64_t malformed; // 遇到的无效字符数
+		std::uint64_t allocated_bytes; // 返回的字符串或者std::vector占用的字节数
+		std::uint64_t nanoseconds; // 转换耗费的纳秒数
+	};
+
+	// 所有编码转换的统计计数
+	// 只在定义了EXTIOS_STATS编译extios库时统计, 否则不会产生任何开销, 计数都是0
+	// 转换函数内部调用的其他转换函数只计入最外层的调用, transcode_file的计数按文件整体计入
+	struct codecvt_stats
+	{
+		bool enabled; // extios库是否统计编码转换
+		conversion_stats pairs[5][5]; // 按输入和输出字符集的值索引的计数
+
+		// 获取一种编码转换的计数
+		// 参数: from 输入的字符集
+		// 参数: to 输出的字符集
+		// 返回值: 统计计数
+		EXTIOSAPI const conversion_stats & at(charset from, charset to) const noexcept;
+	};
+
+	// 获取编码转换的统计计数, 转换同时进行时各计数分别读取, 相互之间可能不一致
+	// 返回值: 调用时的统计计数
+	EXTIOSAPI codecvt_stats stats(void) noexcept;
+
+	// 把编码转换的统计计数清零
+	EXTIOSAPI void reset_stats(void) noexcept;
 }
 
 #endif // !__EXTIOS_CODECVT_H__
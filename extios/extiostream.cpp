@@ -24,3 +24,10 @@ EXTIOS_GLOBAL_DEFINE extios::ext_basic_ostream<char> u8cout(&u8outputbuf);
 EXTIOS_GLOBAL_DEFINE extios::ext_basic_ostream<wchar_t> wcout(&woutputbuf);
 EXTIOS_GLOBAL_DEFINE extios::ext_basic_ostream<char16_t> u16cout(&u16outputbuf);
 EXTIOS_GLOBAL_DEFINE extios::ext_basic_ostream<char32_t> u32cout(&u32outputbuf);
+
+static const bool streams_tied = (
+	u8cin.tie(&u8cout),
+	wcin.tie(&wcout),
+	u16cin.tie(&u16cout),
+	u32cin.tie(&u32cout),
+	true);
@@ -1,8 +1,14 @@
 ﻿#ifndef __EXTIOS_IOSTREAM_HPP__
 #define __EXTIOS_IOSTREAM_HPP__
 
+#include "iobuf.hpp"
 #include <iostream>
 #include <string>
+#include <limits> // std::numeric_limits
+#include <locale> // std::num_put, std::use_facet
+#include <iterator> // std::ostreambuf_iterator
+#include <algorithm> // std::min
+#include <type_traits> // std::make_unsigned
 
 #undef EXTIOS_GLOBAL
 #ifdef _MSC_VER
@@ -22,6 +28,10 @@ namespace extios
 	{
 	public:
 		explicit ext_basic_istream(std::basic_streambuf<charT, Traits> *sb);
+
+		// 流缓冲区不是 basic_inputbuf 时返回全为 0 的统计
+		stream_stats io_stats(void) const;
+		void reset_io_stats(void);
 	};
 
 	template <typename charT, typename Traits = std::char_traits<charT>>
@@ -29,8 +39,45 @@ namespace extios
 	{
 	public:
 		explicit ext_basic_ostream(std::basic_streambuf<charT, Traits> *sb);
+
+		// 流缓冲区不是 basic_outputbuf 时返回全为 0 的统计
+		stream_stats io_stats(void) const;
+		void reset_io_stats(void);
 	};
 
+	namespace _hidden
+	{
+		// 将写入的窄字符追加到 std::string 中的流缓冲区
+		class narrow_stringbuf : public std::streambuf
+		{
+		public:
+			explicit narrow_stringbuf(std::string &text);
+
+		protected:
+			virtual std::streamsize xsputn(const char *s, std::streamsize n) override;
+			virtual int_type overflow(int_type c) override;
+
+		private:
+			std::string &m_text;
+		};
+
+		// 按 std::cout 当前的格式状态格式化数值后写入 ostr 的流缓冲区
+		template<typename charT, typename Traits, typename T>
+		void put_number(ext_basic_ostream<charT, Traits> &ostr, T val);
+
+		// 输入前先刷新与 istr 关联的输出流
+		template<typename charT, typename Traits>
+		void flush_tied(ext_basic_istream<charT, Traits> &istr);
+
+		// 只识别 ASCII 空白
+		template<typename charT>
+		bool is_space(charT ch);
+
+		// 设置了 skipws 时跳过前导空白, char16_t 和 char32_t 没有 ctype 刻面
+		template<typename charT, typename Traits>
+		typename Traits::int_type skip_space(ext_basic_istream<charT, Traits> &istr);
+	}
+
 	template<typename charT, typename Traits>
 	ext_basic_istream<charT, Traits> & operator>>(ext_basic_istream<charT, Traits> &istr, bool &val);
 
@@ -156,15 +203,112 @@ extios::ext_basic_istream<charT, Traits>::ext_basic_istream(std::basic_streambuf
 {
 }
 
+template <typename charT, typename Traits>
+extios::stream_stats extios::ext_basic_istream<charT, Traits>::io_stats(void) const
+{
+	auto buffer = dynamic_cast<basic_inputbuf<charT, Traits> *>(this->rdbuf());
+	return buffer != nullptr ? buffer->stats() : stream_stats();
+}
+
+template <typename charT, typename Traits>
+void extios::ext_basic_istream<charT, Traits>::reset_io_stats(void)
+{
+	auto buffer = dynamic_cast<basic_inputbuf<charT, Traits> *>(this->rdbuf());
+	if (buffer != nullptr)
+	{
+		buffer->reset_stats();
+	}
+}
+
 template <typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits>::ext_basic_ostream(std::basic_streambuf<charT, Traits> *sb)
 	: std::basic_ostream<charT, Traits>(sb)
 {
 }
 
+template <typename charT, typename Traits>
+extios::stream_stats extios::ext_basic_ostream<charT, Traits>::io_stats(void) const
+{
+	auto buffer = dynamic_cast<basic_outputbuf<charT, Traits> *>(this->rdbuf());
+	return buffer != nullptr ? buffer->stats() : stream_stats();
+}
+
+template <typename charT, typename Traits>
+void extios::ext_basic_ostream<charT, Traits>::reset_io_stats(void)
+{
+	auto buffer = dynamic_cast<basic_outputbuf<charT, Traits> *>(this->rdbuf());
+	if (buffer != nullptr)
+	{
+		buffer->reset_stats();
+	}
+}
+
+inline extios::_hidden::narrow_stringbuf::narrow_stringbuf(std::string &text)
+	: m_text(text)
+{
+}
+
+inline std::streamsize extios::_hidden::narrow_stringbuf::xsputn(const char *s, std::streamsize n)
+{
+	m_text.append(s, static_cast<std::size_t>(n));
+	return n;
+}
+
+inline extios::_hidden::narrow_stringbuf::int_type extios::_hidden::narrow_stringbuf::overflow(int_type c)
+{
+	if (!traits_type::eq_int_type(c, traits_type::eof()))
+	{
+		m_text.push_back(traits_type::to_char_type(c));
+	}
+	return traits_type::not_eof(c);
+}
+
+template<typename charT, typename Traits, typename T>
+void extios::_hidden::put_number(ext_basic_ostream<charT, Traits> &ostr, T val)
+{
+	std::string text;
+	narrow_stringbuf buffer(text);
+	const auto &facet = std::use_facet<std::num_put<char>>(std::cout.getloc());
+	facet.put(std::ostreambuf_iterator<char>(&buffer), std::cout, std::cout.fill(), val);
+	std::cout.width(0);
+
+	for (auto ch : text)
+	{
+		if (static_cast<unsigned char>(ch) >= 0x80)
+		{
+			// 区域设置产生了非 ASCII 字符(如千位分隔符), 按多字节字符串转换后输出
+			auto wide = from_multibytes<charT>(text.data(), text.size());
+			ostr.write(wide.data(), static_cast<std::streamsize>(wide.size()));
+			return;
+		}
+	}
+
+	constexpr std::size_t chunk_size = 64;
+	charT wide[chunk_size];
+	for (std::size_t i = 0; i < text.size(); i += chunk_size)
+	{
+		std::size_t count = std::min(chunk_size, text.size() - i);
+		for (std::size_t j = 0; j < count; ++j)
+		{
+			wide[j] = static_cast<charT>(text[i + j]);
+		}
+		ostr.write(wide, static_cast<std::streamsize>(count));
+	}
+}
+
+template<typename charT, typename Traits>
+void extios::_hidden::flush_tied(ext_basic_istream<charT, Traits> &istr)
+{
+	if (istr.tie() != nullptr)
+	{
+		istr.tie()->flush();
+	}
+}
+
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, bool &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -172,6 +316,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, short &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -179,6 +324,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, unsigned short &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -186,6 +332,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, int &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -193,6 +340,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, unsigned int &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -200,6 +348,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, long &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -207,6 +356,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, unsigned long &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -214,6 +364,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, long long &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -221,6 +372,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, unsigned long long &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -228,6 +380,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, float &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -235,6 +388,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, double &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -242,6 +396,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, long double &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -249,6 +404,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, void* &val)
 {
+	_hidden::flush_tied(istr);
 	std::cin >> val;
 	return istr;
 }
@@ -273,17 +429,39 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 
 #include <cctype>
 
+template<typename charT>
+bool extios::_hidden::is_space(charT ch)
+{
+	auto code = static_cast<typename std::make_unsigned<charT>::type>(ch);
+	return code < 0x80 && std::isspace(static_cast<int>(code)) != 0;
+}
+
+template<typename charT, typename Traits>
+typename Traits::int_type extios::_hidden::skip_space(ext_basic_istream<charT, Traits> &istr)
+{
+	typename Traits::int_type meta = istr.rdbuf()->sgetc();
+	if ((istr.flags() & std::ios_base::skipws) != 0)
+	{
+		while (!Traits::eq_int_type(Traits::eof(), meta) && is_space(Traits::to_char_type(meta)))
+		{
+			meta = istr.rdbuf()->snextc();
+		}
+	}
+	return meta;
+}
+
 template<typename charT, typename Traits>
 extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<charT, Traits> &istr, charT *s)
 {
 	using myis = ext_basic_istream<charT, Traits>;
 	std::ios_base::iostate state = std::ios_base::goodbit;
 	charT *str0 = s;
+	_hidden::flush_tied(istr);
 
 	try
 	{
 		std::streamsize count = 0 < istr.width() ? istr.width() : std::numeric_limits<std::streamsize>::max();
-		typename myis::int_type meta = istr.rdbuf()->sgetc();
+		typename myis::int_type meta = _hidden::skip_space(istr);
 		for (; 0 < --count; meta = istr.rdbuf()->snextc())
 		{
 			if (Traits::eq_int_type(Traits::eof(), meta))
@@ -291,7 +469,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 				state |= std::ios_base::eofbit;
 				break;
 			}
-			else if (std::isspace(Traits::to_char_type(meta)) || Traits::to_char_type(meta) == charT())
+			else if (_hidden::is_space(Traits::to_char_type(meta)) || Traits::to_char_type(meta) == charT())
 			{
 				break;
 			}
@@ -321,14 +499,14 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 
 	std::ios_base::iostate state = std::ios_base::goodbit;
 	bool ischanged = false;
-	const typename myis::sentry isok(istr);
+	const typename myis::sentry isok(istr, true);
 
 	s.erase();
 
 	try
 	{
 		mysizt size = 0 < istr.width() && (mysizt)istr.width() < s.max_size() ? (mysizt)istr.width() : s.max_size();
-		typename Traits::int_type meta = istr.rdbuf()->sgetc();
+		typename Traits::int_type meta = _hidden::skip_space(istr);
 
 		for (; 0 < size; --size, meta = istr.rdbuf()->snextc())
 		{
@@ -337,7 +515,7 @@ extios::ext_basic_istream<charT, Traits> & extios::operator>>(ext_basic_istream<
 				state |= std::ios_base::eofbit;
 				break;
 			}
-			else if (std::isspace(Traits::to_char_type(meta)))
+			else if (_hidden::is_space(Traits::to_char_type(meta)))
 			{
 				break;
 			}
@@ -388,91 +566,107 @@ extios::ext_basic_istream<charT, Traits>& extios::operator>>(ext_basic_istream<c
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, bool val)
 {
-	std::cout << val;
+	_hidden::put_number(ostr, val);
 	return ostr;
 }
 
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, short val)
 {
-	std::cout << val;
+	auto basefield = std::cout.flags() & std::ios_base::basefield;
+	if (basefield == std::ios_base::oct || basefield == std::ios_base::hex)
+	{
+		_hidden::put_number(ostr, static_cast<long>(static_cast<unsigned short>(val)));
+	}
+	else
+	{
+		_hidden::put_number(ostr, static_cast<long>(val));
+	}
 	return ostr;
 }
 
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, unsigned short val)
 {
-	std::cout << val;
+	_hidden::put_number(ostr, static_cast<unsigned long>(val));
 	return ostr;
 }
 
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, int val)
 {
-	std::cout << val;
+	auto basefield = std::cout.flags() & std::ios_base::basefield;
+	if (basefield == std::ios_base::oct || basefield == std::ios_base::hex)
+	{
+		_hidden::put_number(ostr, static_cast<long>(static_cast<unsigned int>(val)));
+	}
+	else
+	{
+		_hidden::put_number(ostr, static_cast<long>(val));
+	}
 	return ostr;
 }
 
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, unsigned int val)
 {
-	std::cout << val;
+	_hidden::put_number(ostr, static_cast<unsigned long>(val));
 	return ostr;
 }
 
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, long val)
 {
-	std::cout << val;
+	_hidden::put_number(ostr, val);
 	return ostr;
 }
 
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, unsigned long val)
 {
-	std::cout << val;
+	_hidden::put_number(ostr, val);
 	return ostr;
 }
 
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, long long val)
 {
-	std::cout << val;
+	_hidden::put_number(ostr, val);
 	return ostr;
 }
 
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, unsigned long long val)
 {
-	std::cout << val;
+	_hidden::put_number(ostr, val);
 	return ostr;
 }
 
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, float val)
 {
-	std::cout << val;
+	_hidden::put_number(ostr, static_cast<double>(val));
 	return ostr;
 }
 
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, double val)
 {
-	std::cout << val;
+	_hidden::put_number(ostr, val);
 	return ostr;
 }
 
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, long double val)
 {
-	std::cout << val;
+	_hidden::put_number(ostr, val);
 	return ostr;
 }
 
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, void* val)
 {
-	std::cout << val;
+	_hidden::put_number(ostr, static_cast<const void *>(val));
 	return ostr;
 }
 
@@ -495,7 +689,23 @@ extios::ext_basic_ostream<charT, Traits> & extios::operator<<(ext_basic_ostream<
 template<typename charT, typename Traits>
 extios::ext_basic_ostream<charT, Traits>& extios::operator<<(ext_basic_ostream<charT, Traits> &ostr, std::ostream&(*pf)(std::ostream&))
 {
-	(*pf)(std::cout);
+	// 输出字符的操纵符写入本对象, 使缓冲区改为写入文件描述符后换行仍然写到同一位置
+	using manipulator = std::ostream &(*)(std::ostream &);
+	if (pf == static_cast<manipulator>(std::endl))
+	{
+		ostr.put(static_cast<charT>('\n'));
+	}
+	else if (pf == static_cast<manipulator>(std::ends))
+	{
+		ostr.put(charT());
+	}
+	else if (pf != static_cast<manipulator>(std::flush))
+	{
+		ostr.flush();
+		(*pf)(std::cout);
+		return ostr;
+	}
+	ostr.flush();
 	return ostr;
 }
 
@@ -5,6 +5,19 @@
 #include <streambuf> // std::basic_streambuf
 #include <iostream> // std::cout, std::cin
 #include <cctype> // std::isspace
+#include <limits> // std::numeric_limits
+#include <algorithm> // std::min
+#include <cstdint> // std::uint32_t
+#include <cstring> // std::memcpy
+#include <stdexcept> // std::invalid_argument
+#include <cerrno> // errno, EINTR
+#include <chrono> // std::chrono::steady_clock
+#ifdef _MSC_VER
+#include <io.h> // _read, _write
+#else // _MSC_VER
+#include <unistd.h> // read, write
+#include <sys/uio.h> // writev
+#endif // _MSC_VER
 
 #undef EXTIOSAPI
 #ifdef _MSC_VER
@@ -19,6 +32,17 @@
 
 namespace extios
 {
+	// 流缓冲区的输入输出统计
+	struct stream_stats
+	{
+		std::uint64_t characters; // 输出时已转换的字符数, 输入时解码得到的字符数
+		std::uint64_t bytes; // 输出时转换后写出的字节数, 输入时读取的字节数
+		std::uint64_t flushes; // 刷新(sync)的次数, 包括 std::endl 和 std::flush
+		std::uint64_t io_calls; // read/write/writev 的调用次数, 经过 std::cout/std::cin 时是读写一块的次数
+		std::uint64_t conversion_nanoseconds; // 编码转换耗费的纳秒数
+		std::uint64_t carries; // 末尾不完整的编码序列留待与后续内容一起转换的次数
+	};
+
 	namespace _hidden
 	{
 		template <typename charT>
@@ -35,6 +59,43 @@ namespace extios
 
 		template <>
 		std::vector<char32_t> from_multibytes<char32_t>(const char *s, std::size_t n);
+
+		// 末尾被截断的 UTF-8 序列或 UTF-16 高代理项的字符数
+		template <typename charT>
+		std::size_t incomplete_tail(const charT *s, std::size_t n) noexcept;
+
+		// 依次完整写入两段字节, calls 累加 write/writev 的调用次数
+		bool write_fd(int fd, const char *s1, std::size_t n1, const char *s2, std::size_t n2, std::uint64_t &calls) noexcept;
+
+		// 读取最多 n 个字节, 到达文件末尾或读取失败时返回 0
+		std::size_t read_fd(int fd, char *s, std::size_t n) noexcept;
+
+		std::uint64_t elapsed_nanoseconds(std::chrono::steady_clock::time_point start) noexcept;
+
+		// 逐字节的 UTF-8 解码器, 截断的序列留在解码器中, 无效的字节按最大有效子序列替换为 U+FFFD
+		class utf8_decoder
+		{
+		public:
+			// 输出 UTF-16 或 UTF-32, 剩余空间不足 2 个字符时停止
+			template <typename charT>
+			convert_result decode(const char *s, std::size_t n, charT *dest, std::size_t capacity) noexcept;
+
+			// 残留的不完整序列输出为 U+FFFD
+			template <typename charT>
+			std::size_t finish(charT *dest) noexcept;
+
+			bool pending(void) const noexcept;
+
+		private:
+			template <typename charT>
+			static std::size_t put(char32_t code, charT *dest) noexcept;
+
+		private:
+			char32_t m_code = 0;
+			unsigned int m_needed = 0;
+			unsigned char m_lower = 0x80;
+			unsigned char m_upper = 0xBF;
+		};
 	}
 
 	template <typename charT, typename traits = std::char_traits<charT>>
@@ -49,21 +110,44 @@ namespace extios
 
 	public:
 		basic_inputbuf(void);
+		explicit basic_inputbuf(std::size_t size);
 		basic_inputbuf(const basic_inputbuf &) = delete;
 		basic_inputbuf(basic_inputbuf &&x);
 		~basic_inputbuf(void);
 		basic_inputbuf & operator=(const basic_inputbuf &) = delete;
 		basic_inputbuf & operator=(basic_inputbuf &&x);
 
+	public:
+		// 直接从文件描述符读取, 不再经过 std::cin
+		void attach(int fd);
+		// 恢复为从 std::cin 读取, 已读入缓冲区的内容仍会先被读出
+		void detach(void) noexcept;
+		int fd(void) const noexcept;
+		stream_stats stats(void) const noexcept;
+		void reset_stats(void) noexcept;
+
+	public:
+		static constexpr std::size_t default_buffer_size = 65536;
+		static constexpr std::size_t min_buffer_size = 8;
+
 	protected:
 		virtual int_type underflow(void) override;
 
 	private:
-		static constexpr std::size_t buffer_size = 32;
-		static constexpr std::size_t last_buffer_size = 4;
+		std::size_t read_block(char *s, std::size_t n);
+		std::size_t decode_block(bool ended);
+		void release_buffer(void) noexcept;
+
+	private:
 		char_type * m_buffer;
-		char_type * m_last_buffer;
-		char_type * m_last_buffer_pointer;
+		std::size_t m_buffer_size;
+		char * m_raw_buffer;
+		std::size_t m_raw_size;
+		std::size_t m_raw_begin;
+		std::size_t m_raw_end;
+		_hidden::utf8_decoder m_decoder;
+		int m_fd;
+		stream_stats m_stats;
 	};
 
 	template <typename charT, typename traits = std::char_traits<charT>>
@@ -77,170 +161,982 @@ namespace extios
 		using off_type = typename traits_type::off_type;
 
 	public:
-		basic_outputbuf(void) = default;
+		basic_outputbuf(void);
+		explicit basic_outputbuf(std::size_t size);
 		basic_outputbuf(const basic_outputbuf &) = delete;
-		basic_outputbuf(basic_outputbuf &&) = default;
+		basic_outputbuf(basic_outputbuf &&x);
+		~basic_outputbuf(void);
 		basic_outputbuf & operator=(const basic_outputbuf &) = delete;
-		basic_outputbuf & operator=(basic_outputbuf &&) = default;
+		basic_outputbuf & operator=(basic_outputbuf &&x);
+
+	public:
+		// 直接写入文件描述符, 不再经过 std::cout, 字节缓冲区写满或刷新时才写出
+		bool attach(int fd, std::size_t size = default_sink_size);
+		// 输出缓冲的内容后恢复为写入 std::cout
+		bool detach(void);
+		int fd(void) const noexcept;
+		stream_stats stats(void) const noexcept;
+		void reset_stats(void) noexcept;
+
+	public:
+		static constexpr std::size_t default_buffer_size = 4096;
+		static constexpr std::size_t default_sink_size = 65536;
+		static constexpr std::size_t min_buffer_size = 8;
 
 	protected:
+		// s 为 nullptr 时由本对象分配 n 个字符的缓冲区
+		virtual std::basic_streambuf<charT, traits> * setbuf(char_type *s, std::streamsize n) override;
 		virtual std::streamsize xsputn(const char_type *s, std::streamsize n) override;
 		virtual int_type overflow(int_type c) override;
+		virtual int sync(void) override;
+
+	private:
+		bool flush_buffer(bool complete);
+		bool write_converted(const char_type *s, std::size_t n);
+		bool flush_sink(void);
+		bool write_bytes(const char *s, std::size_t n);
+		void release_buffer(void) noexcept;
+		void release_sink(void) noexcept;
+
+	private:
+		char_type * m_buffer;
+		std::size_t m_buffer_size;
+		bool m_owns_buffer;
+		int m_fd;
+		char * m_sink_buffer;
+		std::size_t m_sink_size;
+		std::size_t m_sink_length;
+		stream_stats m_stats;
 	};
 }
 
 template<>
 inline std::vector<char> extios::_hidden::from_multibytes(const char *s, std::size_t n)
 {
-	return to_utf8_buffer(s, static_cast<unsigned int>(n));
+	return to_utf8_buffer(s, n);
 }
 
 template<>
 inline std::vector<wchar_t> extios::_hidden::from_multibytes(const char *s, std::size_t n)
 {
-	return to_widechar_buffer(s, static_cast<unsigned int>(n), false);
+	return to_widechar_buffer(s, n, false);
 }
 
 template<>
 inline std::vector<char16_t> extios::_hidden::from_multibytes(const char *s, std::size_t n)
 {
-	return to_utf16_buffer(s, static_cast<unsigned int>(n), false);
+	return to_utf16_buffer(s, n, false);
 }
 
 template<>
 inline std::vector<char32_t> extios::_hidden::from_multibytes(const char *s, std::size_t n)
 {
-	return to_utf32_buffer(s, static_cast<unsigned int>(n), false);
+	return to_utf32_buffer(s, n, false);
+}
+
+template<typename charT>
+inline std::size_t extios::_hidden::incomplete_tail(const charT *s, std::size_t n) noexcept
+{
+	if constexpr (sizeof(charT) == 1)
+	{
+		// 向前最多查看 3 个字节, 找到序列的首字节后判断序列是否完整
+		for (std::size_t i = 1; i <= 3 && i <= n; ++i)
+		{
+			auto byte = static_cast<unsigned char>(s[n - i]);
+			if ((byte & 0xC0) != 0x80)
+			{
+				std::size_t length = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+				return i < length ? i : 0;
+			}
+		}
+		return 0;
+	}
+	else if constexpr (sizeof(charT) == 2)
+	{
+		return n != 0 && (static_cast<std::uint32_t>(s[n - 1]) & 0xFC00) == 0xD800 ? 1 : 0;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+inline bool extios::_hidden::write_fd(int fd, const char *s1, std::size_t n1, const char *s2, std::size_t n2, std::uint64_t &calls) noexcept
+{
+#ifdef _MSC_VER
+	const char *data[2] = { s1, s2 };
+	std::size_t size[2] = { n1, n2 };
+	for (int i = 0; i < 2; ++i)
+	{
+		while (size[i] != 0)
+		{
+			auto count = size[i] < 0x40000000 ? static_cast<unsigned int>(size[i]) : 0x40000000u;
+			int written = ::_write(fd, data[i], count);
+			++calls;
+			if (written < 0)
+			{
+				return false;
+			}
+			data[i] += written;
+			size[i] -= static_cast<std::size_t>(written);
+		}
+	}
+	return true;
+#else // _MSC_VER
+	iovec iov[2] = { { const_cast<char *>(s1), n1 }, { const_cast<char *>(s2), n2 } };
+	iovec *first = n1 != 0 ? iov : iov + 1;
+	iovec *last = iov + 2;
+	while (first != last)
+	{
+		ssize_t written = ::writev(fd, first, static_cast<int>(last - first));
+		++calls;
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return false;
+		}
+
+		// 处理部分写入: 跳过已写出的部分
+		auto remain = static_cast<std::size_t>(written);
+		while (first != last && remain >= first->iov_len)
+		{
+			remain -= first->iov_len;
+			++first;
+		}
+		if (first != last)
+		{
+			first->iov_base = static_cast<char *>(first->iov_base) + remain;
+			first->iov_len -= remain;
+		}
+	}
+	return true;
+#endif // _MSC_VER
+}
+
+inline std::size_t extios::_hidden::read_fd(int fd, char *s, std::size_t n) noexcept
+{
+#ifdef _MSC_VER
+	int length = ::_read(fd, s, n < 0x40000000 ? static_cast<unsigned int>(n) : 0x40000000u);
+	return length > 0 ? static_cast<std::size_t>(length) : 0;
+#else // _MSC_VER
+	for (;;)
+	{
+		ssize_t length = ::read(fd, s, n);
+		if (length >= 0)
+		{
+			return static_cast<std::size_t>(length);
+		}
+		if (errno != EINTR)
+		{
+			return 0;
+		}
+	}
+#endif // _MSC_VER
+}
+
+inline std::uint64_t extios::_hidden::elapsed_nanoseconds(std::chrono::steady_clock::time_point start) noexcept
+{
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+template <typename charT>
+inline std::size_t extios::_hidden::utf8_decoder::put(char32_t code, charT *dest) noexcept
+{
+	if constexpr (sizeof(charT) == 2)
+	{
+		if (code >= 0x10000)
+		{
+			code -= 0x10000;
+			dest[0] = static_cast<charT>(0xD800 + (code >> 10));
+			dest[1] = static_cast<charT>(0xDC00 + (code & 0x3FF));
+			return 2;
+		}
+	}
+	dest[0] = static_cast<charT>(code);
+	return 1;
+}
+
+template <typename charT>
+inline extios::convert_result extios::_hidden::utf8_decoder::decode(const char *s, std::size_t n, charT *dest, std::size_t capacity) noexcept
+{
+	static_assert(sizeof(charT) == 2 || sizeof(charT) == 4, "utf8_decoder 只能输出 UTF-16 或 UTF-32");
+
+	auto p = reinterpret_cast<const unsigned char *>(s);
+	auto end = p + n;
+	std::size_t written = 0;
+	while (p != end && written + 2 <= capacity)
+	{
+		unsigned char byte = *p;
+		if (m_needed == 0)
+		{
+			if (byte < 0x80)
+			{
+				// ASCII 连续出现时逐个复制, 不经过状态转移
+				auto limit = p + std::min<std::size_t>(end - p, capacity - written);
+				do
+				{
+					dest[written++] = static_cast<charT>(*p++);
+				} while (p != limit && *p < 0x80);
+				continue;
+			}
+
+			++p;
+			if (byte >= 0xC2 && byte <= 0xDF)
+			{
+				m_code = byte & 0x1F;
+				m_needed = 1;
+			}
+			else if (byte >= 0xE0 && byte <= 0xEF)
+			{
+				m_code = byte & 0x0F;
+				m_needed = 2;
+				m_lower = byte == 0xE0 ? 0xA0 : 0x80;
+				m_upper = byte == 0xED ? 0x9F : 0xBF;
+			}
+			else if (byte >= 0xF0 && byte <= 0xF4)
+			{
+				m_code = byte & 0x07;
+				m_needed = 3;
+				m_lower = byte == 0xF0 ? 0x90 : 0x80;
+				m_upper = byte == 0xF4 ? 0x8F : 0xBF;
+			}
+			else
+			{
+				written += put<charT>(0xFFFD, dest + written);
+			}
+		}
+		else if (byte >= m_lower && byte <= m_upper)
+		{
+			++p;
+			m_code = (m_code << 6) | (byte & 0x3F);
+			m_lower = 0x80;
+			m_upper = 0xBF;
+			if (--m_needed == 0)
+			{
+				written += put<charT>(m_code, dest + written);
+			}
+		}
+		else
+		{
+			// 序列被打断, 已读入的部分替换为 U+FFFD, 当前字节重新作为序列开头解码
+			m_needed = 0;
+			m_lower = 0x80;
+			m_upper = 0xBF;
+			written += put<charT>(0xFFFD, dest + written);
+		}
+	}
+
+	return convert_result{ static_cast<std::size_t>(p - reinterpret_cast<const unsigned char *>(s)), written };
+}
+
+template <typename charT>
+inline std::size_t extios::_hidden::utf8_decoder::finish(charT *dest) noexcept
+{
+	if (m_needed == 0)
+	{
+		return 0;
+	}
+
+	m_needed = 0;
+	m_lower = 0x80;
+	m_upper = 0xBF;
+	return put<charT>(0xFFFD, dest);
+}
+
+inline bool extios::_hidden::utf8_decoder::pending(void) const noexcept
+{
+	return m_needed != 0;
 }
 
 template<typename charT, typename traits>
 inline extios::basic_inputbuf<charT, traits>::basic_inputbuf(void)
-	: m_buffer(new char_type[buffer_size])
-	, m_last_buffer(new char_type[last_buffer_size])
-	, m_last_buffer_pointer(m_last_buffer)
+	: basic_inputbuf(default_buffer_size)
+{
+}
+
+template<typename charT, typename traits>
+inline extios::basic_inputbuf<charT, traits>::basic_inputbuf(std::size_t size)
+	: m_buffer(nullptr)
+	, m_buffer_size(size < min_buffer_size ? min_buffer_size : size)
+	, m_raw_buffer(nullptr)
+	, m_raw_size(m_buffer_size)
+	, m_raw_begin(0)
+	, m_raw_end(0)
+	, m_fd(-1)
+	, m_stats()
 {
-	this->setg(m_buffer, m_buffer + buffer_size, m_buffer + buffer_size);
+	m_buffer = new char_type[m_buffer_size];
+	m_raw_buffer = new char[m_raw_size];
+	this->setg(m_buffer, m_buffer, m_buffer);
 }
 
 template<typename charT, typename traits>
 inline extios::basic_inputbuf<charT, traits>::basic_inputbuf(basic_inputbuf &&x)
-	: m_buffer(x.m_buffer)
-	, m_last_buffer(x.m_last_buffer)
-	, m_last_buffer_pointer(x.m_last_buffer_pointer)
+	: std::basic_streambuf<charT, traits>(x)
+	, m_buffer(x.m_buffer)
+	, m_buffer_size(x.m_buffer_size)
+	, m_raw_buffer(x.m_raw_buffer)
+	, m_raw_size(x.m_raw_size)
+	, m_raw_begin(x.m_raw_begin)
+	, m_raw_end(x.m_raw_end)
+	, m_decoder(x.m_decoder)
+	, m_fd(x.m_fd)
+	, m_stats(x.m_stats)
 {
 	x.m_buffer = nullptr;
-	x.m_last_buffer = nullptr;
-	x.m_last_buffer_pointer = nullptr;
+	x.m_raw_buffer = nullptr;
+	x.release_buffer();
 }
 
 template<typename charT, typename traits>
 inline extios::basic_inputbuf<charT, traits>::~basic_inputbuf(void)
 {
-	if (m_last_buffer != nullptr)
+	release_buffer();
+}
+
+template<typename charT, typename traits>
+inline extios::basic_inputbuf<charT, traits> & extios::basic_inputbuf<charT, traits>::operator=(basic_inputbuf &&x)
+{
+	if (this != &x)
 	{
-		delete[] m_last_buffer;
+		release_buffer();
+		std::basic_streambuf<charT, traits>::operator=(x);
+		m_buffer = x.m_buffer;
+		m_buffer_size = x.m_buffer_size;
+		m_raw_buffer = x.m_raw_buffer;
+		m_raw_size = x.m_raw_size;
+		m_raw_begin = x.m_raw_begin;
+		m_raw_end = x.m_raw_end;
+		m_decoder = x.m_decoder;
+		m_fd = x.m_fd;
+		m_stats = x.m_stats;
+		x.m_buffer = nullptr;
+		x.m_raw_buffer = nullptr;
+		x.release_buffer();
 	}
-	if (m_buffer != nullptr)
+	return *this;
+}
+
+template<typename charT, typename traits>
+inline void extios::basic_inputbuf<charT, traits>::attach(int fd)
+{
+	if (fd < 0)
 	{
-		delete[] m_buffer;
+		throw std::invalid_argument("文件描述符无效");
 	}
+	m_fd = fd;
 }
 
 template<typename charT, typename traits>
-inline extios::basic_inputbuf<charT, traits> & extios::basic_inputbuf<charT, traits>::operator=(basic_inputbuf &&x)
+inline void extios::basic_inputbuf<charT, traits>::detach(void) noexcept
 {
-	m_buffer = x.m_buffer;
-	m_last_buffer = x.m_last_buffer;
-	m_last_buffer_pointer = x.m_last_buffer_pointer;
-	x.m_buffer = nullptr;
-	x.m_last_buffer = nullptr;
-	x.m_last_buffer_pointer = nullptr;
+	m_fd = -1;
+}
+
+template<typename charT, typename traits>
+inline int extios::basic_inputbuf<charT, traits>::fd(void) const noexcept
+{
+	return m_fd;
+}
+
+template<typename charT, typename traits>
+inline extios::stream_stats extios::basic_inputbuf<charT, traits>::stats(void) const noexcept
+{
+	return m_stats;
+}
+
+template<typename charT, typename traits>
+inline void extios::basic_inputbuf<charT, traits>::reset_stats(void) noexcept
+{
+	m_stats = stream_stats();
 }
 
 template<typename charT, typename traits>
 inline typename extios::basic_inputbuf<charT, traits>::int_type extios::basic_inputbuf<charT, traits>::underflow(void)
 {
-	this->setg(m_buffer, m_buffer, m_buffer + buffer_size);
+	if (this->gptr() != this->egptr())
+	{
+		return traits_type::to_int_type(*(this->gptr()));
+	}
+	if (m_buffer == nullptr)
+	{
+		return traits_type::eof();
+	}
 
-	for (auto p = m_last_buffer; p != m_last_buffer_pointer; ++p)
+	bool ended = false;
+	auto start = std::chrono::steady_clock::now();
+	std::size_t written = decode_block(ended);
+	m_stats.conversion_nanoseconds += _hidden::elapsed_nanoseconds(start);
+	while (written == 0 && !ended)
 	{
-		*(this->gptr()) = (*p);
-		this->gbump(1);
+		if (m_raw_begin == m_raw_end)
+		{
+			m_raw_begin = 0;
+			m_raw_end = 0;
+		}
+		else if (m_raw_begin != 0)
+		{
+			// 把未解码的字节移到开头, 使后续字节能整块读入
+			std::memmove(m_raw_buffer, m_raw_buffer + m_raw_begin, m_raw_end - m_raw_begin);
+			m_raw_end -= m_raw_begin;
+			m_raw_begin = 0;
+		}
+
+		auto length = read_block(m_raw_buffer + m_raw_end, m_raw_size - m_raw_end);
+		m_raw_end += length;
+		m_stats.bytes += length;
+		ended = length == 0;
+		start = std::chrono::steady_clock::now();
+		written = decode_block(ended);
+		m_stats.conversion_nanoseconds += _hidden::elapsed_nanoseconds(start);
 	}
-	m_last_buffer_pointer = m_last_buffer;
 
-	constexpr std::size_t temp_size = 4;
-	char temp[temp_size]{};
-	char *p = temp;
-	do
+	m_stats.characters += written;
+	this->setg(m_buffer, m_buffer, m_buffer + written);
+	return written == 0 ? traits_type::eof() : traits_type::to_int_type(*m_buffer);
+}
+
+// 从 std::cin 读取时读到换行符且没有可立即读取的字节就返回, 交互输入时不等待整块读满
+template<typename charT, typename traits>
+inline std::size_t extios::basic_inputbuf<charT, traits>::read_block(char *s, std::size_t n)
+{
+	++m_stats.io_calls;
+	if (m_fd >= 0)
+	{
+		return _hidden::read_fd(m_fd, s, n);
+	}
+
+	auto buffer = std::cin.rdbuf();
+	std::size_t length = 0;
+	while (length < n)
 	{
-		if (p - temp == temp_size)
+		auto available = buffer->in_avail();
+		if (available > 0)
+		{
+			auto count = std::min<std::size_t>(static_cast<std::size_t>(available), n - length);
+			length += static_cast<std::size_t>(buffer->sgetn(s + length, static_cast<std::streamsize>(count)));
+			continue;
+		}
+		if (length != 0 && s[length - 1] == '\n')
 		{
 			break;
 		}
 
-		*p++ = static_cast<char>(std::cin.rdbuf()->sbumpc());
-		if (traits_type::eq_int_type(p[-1], '\n') || traits_type::eq_int_type(p[-1], traits_type::eof()))
+		auto c = buffer->sbumpc();
+		if (std::char_traits<char>::eq_int_type(c, std::char_traits<char>::eof()))
 		{
-			*(this->gptr()) = traits_type::to_char_type(p[-1]);
-			this->gbump(1);
 			break;
 		}
+		s[length++] = std::char_traits<char>::to_char_type(c);
+	}
+	return length;
+}
 
-		try
+// 返回 0 表示需要读取更多字节, ended 为 true 时一并输出不完整的序列
+template<typename charT, typename traits>
+inline std::size_t extios::basic_inputbuf<charT, traits>::decode_block(bool ended)
+{
+	auto s = m_raw_buffer + m_raw_begin;
+	auto n = m_raw_end - m_raw_begin;
+#ifdef _MSC_VER
+	// 多字节字符串使用 ANSI 代码页, 按行转换, 行不完整时等待后续字节
+	std::size_t count = n;
+	while (count != 0 && s[count - 1] != '\n')
+	{
+		--count;
+	}
+	if (count == 0 && (ended || (m_raw_begin == 0 && m_raw_end == m_raw_size)))
+	{
+		count = n;
+	}
+	if (count == 0)
+	{
+		return 0;
+	}
+	if (count != n)
+	{
+		++m_stats.carries;
+	}
+
+	auto buffer = _hidden::from_multibytes<char_type>(s, count);
+	if (buffer.size() > m_buffer_size)
+	{
+		// 转换成 UTF-8 时字符数可能多于字节数
+		delete[] m_buffer;
+		m_buffer = new char_type[buffer.size()];
+		m_buffer_size = buffer.size();
+	}
+	traits_type::copy(m_buffer, buffer.data(), buffer.size());
+	m_raw_begin += count;
+	return buffer.size();
+#else // _MSC_VER
+	if constexpr (sizeof(char_type) == 1)
+	{
+		// 多字节字符串就是 UTF-8, 原样复制
+		static_cast<void>(ended);
+		std::memcpy(m_buffer, s, n);
+		m_raw_begin = m_raw_end;
+		return n;
+	}
+	else
+	{
+		if (n == 0)
+		{
+			return ended ? m_decoder.finish(m_buffer) : 0;
+		}
+
+		std::size_t written = 0;
+		if (m_decoder.pending())
 		{
-			auto buffer = _hidden::from_multibytes<char_type>(temp, p - temp);
-			if (p[-1] != '?' && buffer.back() == traits_type::to_char_type('?'))
+			// 状态机只补全上次留下的序列, 之后的字节回到向量化的转换
+			while (m_decoder.pending() && n != 0 && written + 2 <= m_buffer_size)
 			{
-				throw std::invalid_argument("");
+				auto result = m_decoder.decode(s, 1, m_buffer + written, m_buffer_size - written);
+				s += result.consumed;
+				n -= result.consumed;
+				m_raw_begin += result.consumed;
+				written += result.written;
 			}
-
-			if (buffer.size() > static_cast<std::size_t>(this->egptr() - this->gptr()))
+			if (m_decoder.pending())
 			{
-				std::size_t i = 0;
-				for (; i < last_buffer_size && i < buffer.size(); ++i)
-				{
-					m_last_buffer[i] = buffer[i];
-				}
-				m_last_buffer_pointer = m_last_buffer + i;
-				break;
+				return written != 0 || !ended ? written : m_decoder.finish(m_buffer);
 			}
+		}
 
-			for (auto ch : buffer)
+		auto count = n - _hidden::incomplete_tail(s, n);
+		if (count == 0 && !ended)
+		{
+			// 只剩被截断的序列, 留在字节缓冲区中与后续字节一起转换
+			return written;
+		}
+		if (count != 0 && is_valid_utf8(s, count))
+		{
+			// 不含截断序列的部分有效时使用向量化的转换
+			auto result = convert_into(s, count, m_buffer + written, m_buffer_size - written);
+			m_raw_begin += result.consumed;
+			if (count != n && result.consumed == count)
 			{
-				*(this->gptr()) = ch;
-				this->gbump(1);
+				++m_stats.carries;
 			}
-
-			p = temp;
+			return written + result.written;
 		}
-		catch (const std::invalid_argument &)
+
+		// 含有无效字节或输入已经结束时交给状态机
+		auto result = m_decoder.decode(s, n, m_buffer + written, m_buffer_size - written);
+		m_raw_begin += result.consumed;
+		written += result.written;
+		if (result.consumed == n && m_decoder.pending())
 		{
+			if (!ended)
+			{
+				++m_stats.carries;
+			}
+			else if (written < m_buffer_size)
+			{
+				written += m_decoder.finish(m_buffer + written);
+			}
 		}
-	} while ((this->gptr() != this->egptr()));
-	this->setg(m_buffer, m_buffer, this->gptr());
-	return traits_type::to_int_type(*m_buffer);
+		return written;
+	}
+#endif // _MSC_VER
+}
+
+template<typename charT, typename traits>
+inline void extios::basic_inputbuf<charT, traits>::release_buffer(void) noexcept
+{
+	if (m_raw_buffer != nullptr)
+	{
+		delete[] m_raw_buffer;
+	}
+	if (m_buffer != nullptr)
+	{
+		delete[] m_buffer;
+	}
+	m_buffer = nullptr;
+	m_buffer_size = 0;
+	m_raw_buffer = nullptr;
+	m_raw_size = 0;
+	m_raw_begin = 0;
+	m_raw_end = 0;
+	m_fd = -1;
+	this->setg(nullptr, nullptr, nullptr);
+}
+
+template<typename charT, typename traits>
+inline extios::basic_outputbuf<charT, traits>::basic_outputbuf(void)
+	: basic_outputbuf(default_buffer_size)
+{
+}
+
+template<typename charT, typename traits>
+inline extios::basic_outputbuf<charT, traits>::basic_outputbuf(std::size_t size)
+	: m_buffer(nullptr)
+	, m_buffer_size(size < min_buffer_size ? min_buffer_size : size)
+	, m_owns_buffer(true)
+	, m_fd(-1)
+	, m_sink_buffer(nullptr)
+	, m_sink_size(0)
+	, m_sink_length(0)
+	, m_stats()
+{
+	m_buffer = new char_type[m_buffer_size];
+	this->setp(m_buffer, m_buffer + m_buffer_size);
+}
+
+template<typename charT, typename traits>
+inline extios::basic_outputbuf<charT, traits>::basic_outputbuf(basic_outputbuf &&x)
+	: std::basic_streambuf<charT, traits>(x)
+	, m_buffer(x.m_buffer)
+	, m_buffer_size(x.m_buffer_size)
+	, m_owns_buffer(x.m_owns_buffer)
+	, m_fd(x.m_fd)
+	, m_sink_buffer(x.m_sink_buffer)
+	, m_sink_size(x.m_sink_size)
+	, m_sink_length(x.m_sink_length)
+	, m_stats(x.m_stats)
+{
+	x.m_buffer = nullptr;
+	x.m_buffer_size = 0;
+	x.m_owns_buffer = false;
+	x.setp(nullptr, nullptr);
+	x.m_fd = -1;
+	x.m_sink_buffer = nullptr;
+	x.m_sink_size = 0;
+	x.m_sink_length = 0;
+}
+
+template<typename charT, typename traits>
+inline extios::basic_outputbuf<charT, traits>::~basic_outputbuf(void)
+{
+	try
+	{
+		flush_buffer(true);
+	}
+	catch (...)
+	{
+	}
+	flush_sink();
+	release_buffer();
+	release_sink();
+}
+
+template<typename charT, typename traits>
+inline extios::basic_outputbuf<charT, traits> & extios::basic_outputbuf<charT, traits>::operator=(basic_outputbuf &&x)
+{
+	if (this != &x)
+	{
+		flush_buffer(true);
+		flush_sink();
+		release_buffer();
+		release_sink();
+		std::basic_streambuf<charT, traits>::operator=(x);
+		m_buffer = x.m_buffer;
+		m_buffer_size = x.m_buffer_size;
+		m_owns_buffer = x.m_owns_buffer;
+		m_fd = x.m_fd;
+		m_sink_buffer = x.m_sink_buffer;
+		m_sink_size = x.m_sink_size;
+		m_sink_length = x.m_sink_length;
+		m_stats = x.m_stats;
+		x.m_buffer = nullptr;
+		x.m_buffer_size = 0;
+		x.m_owns_buffer = false;
+		x.setp(nullptr, nullptr);
+		x.m_fd = -1;
+		x.m_sink_buffer = nullptr;
+		x.m_sink_size = 0;
+		x.m_sink_length = 0;
+	}
+	return *this;
+}
+
+template<typename charT, typename traits>
+inline bool extios::basic_outputbuf<charT, traits>::attach(int fd, std::size_t size)
+{
+	if (fd < 0)
+	{
+		throw std::invalid_argument("文件描述符无效");
+	}
+
+	// 先把缓冲的内容写到原来的目标, 避免先后顺序错乱
+	if (!flush_buffer(false) || !flush_sink())
+	{
+		return false;
+	}
+	if (m_fd < 0 && std::cout.rdbuf()->pubsync() != 0)
+	{
+		return false;
+	}
+
+	size = size < min_buffer_size ? min_buffer_size : size;
+	if (m_sink_size != size)
+	{
+		release_sink();
+		m_sink_buffer = new char[size];
+		m_sink_size = size;
+	}
+	m_fd = fd;
+	return true;
+}
+
+template<typename charT, typename traits>
+inline bool extios::basic_outputbuf<charT, traits>::detach(void)
+{
+	bool isok = flush_buffer(false) && flush_sink();
+	release_sink();
+	m_fd = -1;
+	return isok;
+}
+
+template<typename charT, typename traits>
+inline int extios::basic_outputbuf<charT, traits>::fd(void) const noexcept
+{
+	return m_fd;
+}
+
+template<typename charT, typename traits>
+inline extios::stream_stats extios::basic_outputbuf<charT, traits>::stats(void) const noexcept
+{
+	return m_stats;
+}
+
+template<typename charT, typename traits>
+inline void extios::basic_outputbuf<charT, traits>::reset_stats(void) noexcept
+{
+	m_stats = stream_stats();
+}
+
+template<typename charT, typename traits>
+inline std::basic_streambuf<charT, traits> * extios::basic_outputbuf<charT, traits>::setbuf(char_type *s, std::streamsize n)
+{
+	if ((s != nullptr && static_cast<std::size_t>(n) < min_buffer_size) || !flush_buffer(true))
+	{
+		return nullptr;
+	}
+
+	release_buffer();
+	if (s != nullptr)
+	{
+		m_buffer = s;
+		m_buffer_size = static_cast<std::size_t>(n);
+		m_owns_buffer = false;
+	}
+	else
+	{
+		m_buffer_size = 0 < n && min_buffer_size < static_cast<std::size_t>(n) ? static_cast<std::size_t>(n) : min_buffer_size;
+		m_buffer = new char_type[m_buffer_size];
+		m_owns_buffer = true;
+	}
+	this->setp(m_buffer, m_buffer + m_buffer_size);
+	return this;
 }
 
 template<typename charT, typename traits>
 inline std::streamsize extios::basic_outputbuf<charT, traits>::xsputn(const char_type *s, std::streamsize n)
 {
-	if (n > std::numeric_limits<int>::max())
+	std::streamsize written = 0;
+	while (written < n)
 	{
-		std::length_error("需要输出的字符串过长");
+		if (this->pptr() == this->epptr() && !flush_buffer(false))
+		{
+			break;
+		}
+
+		auto count = std::min<std::streamsize>(this->epptr() - this->pptr(), n - written);
+		traits_type::copy(this->pptr(), s + written, static_cast<std::size_t>(count));
+		this->pbump(static_cast<int>(count));
+		written += count;
 	}
-	auto buffer = to_multibyte_buffer(s, static_cast<unsigned int>(n));
-	std::cout.rdbuf()->sputn(buffer.data(), buffer.size());
-	return n;
+	return written;
 }
 
 template<typename charT, typename traits>
 inline typename extios::basic_outputbuf<charT, traits>::int_type extios::basic_outputbuf<charT, traits>::overflow(int_type c)
 {
-	auto ch = static_cast<char_type>(c);
-	auto buffer = to_multibyte_buffer(&ch, 1);
-	std::cout.rdbuf()->sputn(buffer.data(), buffer.size());
+	if (this->pptr() == this->epptr() && !flush_buffer(false))
+	{
+		return traits_type::eof();
+	}
+
+	if (traits_type::eq_int_type(c, traits_type::eof()))
+	{
+		return traits_type::not_eof(c);
+	}
+
+	*(this->pptr()) = traits_type::to_char_type(c);
+	this->pbump(1);
 	return c;
 }
 
+template<typename charT, typename traits>
+inline int extios::basic_outputbuf<charT, traits>::sync(void)
+{
+	++m_stats.flushes;
+	if (!flush_buffer(false))
+	{
+		return -1;
+	}
+	if (m_fd >= 0)
+	{
+		return flush_sink() ? 0 : -1;
+	}
+	return std::cout.rdbuf()->pubsync();
+}
+
+// complete 为 false 时末尾不完整的编码序列留在缓冲区中, 转换失败时丢弃缓冲区中的内容
+template<typename charT, typename traits>
+inline bool extios::basic_outputbuf<charT, traits>::flush_buffer(bool complete)
+{
+	if (m_buffer == nullptr)
+	{
+		return true;
+	}
+
+	auto n = static_cast<std::size_t>(this->pptr() - this->pbase());
+	auto tail = complete ? 0 : _hidden::incomplete_tail(this->pbase(), n);
+	bool isok = true;
+	if (n != tail)
+	{
+		try
+		{
+			isok = write_converted(this->pbase(), n - tail);
+			m_stats.characters += n - tail;
+		}
+		catch (...)
+		{
+			this->setp(m_buffer, m_buffer + m_buffer_size);
+			throw;
+		}
+	}
+
+	if (tail != 0)
+	{
+		++m_stats.carries;
+	}
+	traits_type::move(m_buffer, this->pbase() + (n - tail), tail);
+	this->setp(m_buffer, m_buffer + m_buffer_size);
+	this->pbump(static_cast<int>(tail));
+	return isok;
+}
+
+template<typename charT, typename traits>
+inline bool extios::basic_outputbuf<charT, traits>::write_converted(const char_type *s, std::size_t n)
+{
+#ifdef _MSC_VER
+	// ANSI 代码页没有输出到调用者空间的转换
+	auto start = std::chrono::steady_clock::now();
+	auto buffer = to_multibyte_buffer(s, n);
+	m_stats.conversion_nanoseconds += _hidden::elapsed_nanoseconds(start);
+	m_stats.bytes += buffer.size();
+	return write_bytes(buffer.data(), buffer.size());
+#else // _MSC_VER
+	if constexpr (sizeof(char_type) == 1)
+	{
+		m_stats.bytes += n;
+		return write_bytes(s, n);
+	}
+	else
+	{
+		// 写入 std::cout 时字节缓冲区只作为转换的中间空间
+		if (m_sink_buffer == nullptr)
+		{
+			m_sink_buffer = new char[default_sink_size];
+			m_sink_size = default_sink_size;
+		}
+		for (;;)
+		{
+			auto start = std::chrono::steady_clock::now();
+			auto result = convert_into(s, n, m_sink_buffer + m_sink_length, m_sink_size - m_sink_length);
+			m_stats.conversion_nanoseconds += _hidden::elapsed_nanoseconds(start);
+			m_stats.bytes += result.written;
+			m_sink_length += result.written;
+			s += result.consumed;
+			n -= result.consumed;
+			if (n == 0)
+			{
+				break;
+			}
+			if (!flush_sink())
+			{
+				return false;
+			}
+		}
+		return m_fd >= 0 || flush_sink();
+	}
+#endif // _MSC_VER
+}
+
+template<typename charT, typename traits>
+inline bool extios::basic_outputbuf<charT, traits>::flush_sink(void)
+{
+	if (m_sink_length == 0)
+	{
+		return true;
+	}
+
+	bool isok;
+	if (m_fd < 0)
+	{
+		++m_stats.io_calls;
+		isok = std::cout.rdbuf()->sputn(m_sink_buffer, static_cast<std::streamsize>(m_sink_length)) == static_cast<std::streamsize>(m_sink_length);
+	}
+	else
+	{
+		isok = _hidden::write_fd(m_fd, m_sink_buffer, m_sink_length, nullptr, 0, m_stats.io_calls);
+	}
+	m_sink_length = 0;
+	return isok;
+}
+
+// 字节缓冲区放不下时与缓冲区中的内容一起写出
+template<typename charT, typename traits>
+inline bool extios::basic_outputbuf<charT, traits>::write_bytes(const char *s, std::size_t n)
+{
+	if (m_fd < 0)
+	{
+		++m_stats.io_calls;
+		return std::cout.rdbuf()->sputn(s, static_cast<std::streamsize>(n)) == static_cast<std::streamsize>(n);
+	}
+
+	if (n <= m_sink_size - m_sink_length)
+	{
+		std::memcpy(m_sink_buffer + m_sink_length, s, n);
+		m_sink_length += n;
+		return true;
+	}
+
+	bool isok = _hidden::write_fd(m_fd, m_sink_buffer, m_sink_length, s, n, m_stats.io_calls);
+	m_sink_length = 0;
+	return isok;
+}
+
+template<typename charT, typename traits>
+inline void extios::basic_outputbuf<charT, traits>::release_buffer(void) noexcept
+{
+	if (m_owns_buffer && m_buffer != nullptr)
+	{
+		delete[] m_buffer;
+	}
+	m_buffer = nullptr;
+	m_buffer_size = 0;
+	m_owns_buffer = false;
+	this->setp(nullptr, nullptr);
+}
+
+template<typename charT, typename traits>
+inline void extios::basic_outputbuf<charT, traits>::release_sink(void) noexcept
+{
+	if (m_sink_buffer != nullptr)
+	{
+		delete[] m_sink_buffer;
+	}
+	m_sink_buffer = nullptr;
+	m_sink_size = 0;
+	m_sink_length = 0;
+}
+
 #endif // !__EXTIOS_IOBUF_HPP__
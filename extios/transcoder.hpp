@@ -0,0 +1,361 @@
+﻿#ifndef __EXTIOS_TRANSCODER_HPP__
+#define __EXTIOS_TRANSCODER_HPP__
+
+#include "extcodecvt.h"
+#include <algorithm> // std::min std::max
+#include <cstdint> // std::uint64_t
+#include <cstring> // std::memcpy std::memmove
+#include <stdexcept> // std::invalid_argument
+
+namespace extios
+{
+	namespace _hidden
+	{
+		// 字符集对应的字符类型
+		template <charset cs>
+		struct charset_char;
+
+		template <>
+		struct charset_char<charset::multibyte>
+		{
+			using type = char;
+		};
+
+		template <>
+		struct charset_char<charset::widechar>
+		{
+			using type = wchar_t;
+		};
+
+		template <>
+		struct charset_char<charset::utf8>
+		{
+			using type = char;
+		};
+
+		template <>
+		struct charset_char<charset::utf16>
+		{
+			using type = char16_t;
+		};
+
+		template <>
+		struct charset_char<charset::utf32>
+		{
+			using type = char32_t;
+		};
+	}
+
+	// 流式的编码转换类, 被分块截断的字符保存在本对象中与下一块输入数据一起转换, 只支持Unicode字符集之间的转换
+	template <charset from, charset to>
+	class transcoder
+	{
+		static_assert(from != charset::multibyte && to != charset::multibyte, "The transcoder only supports Unicode charsets.");
+		static_assert(from != to, "The transcoder requires different charsets.");
+
+	public:
+		using input_type = typename _hidden::charset_char<from>::type;
+		using output_type = typename _hidden::charset_char<to>::type;
+
+	public:
+		// size 是输出缓冲区初始可容纳的字符数, 输入数据较多时自动扩大
+		explicit transcoder(error_policy policy = error_policy::throw_exception, std::size_t size = default_buffer_size);
+		transcoder(const transcoder &) = delete;
+		transcoder(transcoder &&x) noexcept;
+		~transcoder(void);
+		transcoder & operator=(const transcoder &) = delete;
+		transcoder & operator=(transcoder &&x) noexcept;
+
+	public:
+		// 返回本次输出的字符数, 输出内容由 data() 取得, 停止后不再转换
+		std::size_t feed(const input_type *s, std::size_t n);
+		std::size_t feed(const std::basic_string<input_type> &text);
+
+		// 输入结束时调用, 保存的不完整字符按无效字符处理, 处理方式是 stop 时之后需要 reset() 才能继续转换
+		std::size_t finish(void);
+
+		// 丢弃保存的不完整字符, 清除已转换的字符数、出错位置和停止状态
+		void reset(void) noexcept;
+
+		const output_type * data(void) const noexcept;
+		std::size_t size(void) const noexcept;
+		// 不包括保存在本对象中的不完整字符
+		std::uint64_t consumed(void) const noexcept;
+		// 第一个无效字符在全部输入数据中的位置, 没有时返回 no_error
+		std::uint64_t error_position(void) const noexcept;
+		// 处理方式是 stop 且已经遇到无效的字符时返回 true
+		bool stopped(void) const noexcept;
+		const codecvtor<from, to> & convertor(void) const noexcept;
+
+	public:
+		static constexpr std::size_t default_buffer_size = 65536;
+		static constexpr std::uint64_t no_error = static_cast<std::uint64_t>(-1);
+
+	private:
+		// 每个输入字符最多输出的字符数, 替换无效字符时也不会超过
+		static constexpr std::size_t max_expansion = sizeof(output_type) == 1 ? (sizeof(input_type) == 2 ? 3 : 4) : (sizeof(output_type) == 2 && sizeof(input_type) == 4 ? 2 : 1);
+		static constexpr std::size_t pending_size = 8;
+
+	private:
+		std::size_t convert(const input_type *s, std::size_t n);
+		void reserve(std::size_t n);
+		void release_buffer(void) noexcept;
+
+	private:
+		codecvtor<from, to> m_cvtor;
+		output_type * m_buffer;
+		std::size_t m_capacity;
+		std::size_t m_size;
+		input_type m_pending[pending_size];
+		std::size_t m_pending_size;
+		std::uint64_t m_consumed;
+		std::uint64_t m_error_position;
+		bool m_stopped;
+	};
+}
+
+template <extios::charset from, extios::charset to>
+inline extios::transcoder<from, to>::transcoder(error_policy policy, std::size_t size)
+	: m_cvtor(policy)
+	, m_buffer(nullptr)
+	, m_capacity(std::max<std::size_t>(size, pending_size * max_expansion))
+	, m_size(0)
+	, m_pending_size(0)
+	, m_consumed(0)
+	, m_error_position(no_error)
+	, m_stopped(false)
+{
+	m_buffer = new output_type[m_capacity];
+}
+
+template <extios::charset from, extios::charset to>
+inline extios::transcoder<from, to>::transcoder(transcoder &&x) noexcept
+	: m_cvtor(std::move(x.m_cvtor))
+	, m_buffer(x.m_buffer)
+	, m_capacity(x.m_capacity)
+	, m_size(x.m_size)
+	, m_pending_size(x.m_pending_size)
+	, m_consumed(x.m_consumed)
+	, m_error_position(x.m_error_position)
+	, m_stopped(x.m_stopped)
+{
+	std::memcpy(m_pending, x.m_pending, sizeof(m_pending));
+	x.m_buffer = nullptr;
+	x.m_capacity = 0;
+	x.m_size = 0;
+	x.m_pending_size = 0;
+}
+
+template <extios::charset from, extios::charset to>
+inline extios::transcoder<from, to>::~transcoder(void)
+{
+	release_buffer();
+}
+
+template <extios::charset from, extios::charset to>
+inline extios::transcoder<from, to> & extios::transcoder<from, to>::operator=(transcoder &&x) noexcept
+{
+	if (this != &x)
+	{
+		release_buffer();
+		m_cvtor = std::move(x.m_cvtor);
+		m_buffer = x.m_buffer;
+		m_capacity = x.m_capacity;
+		m_size = x.m_size;
+		std::memcpy(m_pending, x.m_pending, sizeof(m_pending));
+		m_pending_size = x.m_pending_size;
+		m_consumed = x.m_consumed;
+		m_error_position = x.m_error_position;
+		m_stopped = x.m_stopped;
+		x.m_buffer = nullptr;
+		x.m_capacity = 0;
+		x.m_size = 0;
+		x.m_pending_size = 0;
+	}
+	return *this;
+}
+
+template <extios::charset from, extios::charset to>
+inline std::size_t extios::transcoder<from, to>::feed(const input_type *s, std::size_t n)
+{
+	m_size = 0;
+	if (m_stopped)
+	{
+		return 0;
+	}
+
+	std::size_t start = 0;
+	if (m_pending_size > 0)
+	{
+		// 保存的不完整字符和新数据的开头拼接后转换, 之后新数据从完整字符的边界开始转换
+		auto k = m_pending_size;
+		auto extra = std::min(n, pending_size - k);
+		std::memcpy(m_pending + k, s, extra * sizeof(input_type));
+		reserve((k + extra) * max_expansion);
+		auto c = convert(m_pending, k + extra);
+		if (m_stopped)
+		{
+			m_pending_size = 0;
+			return m_size;
+		}
+		if (c < k)
+		{
+			// 拼接后仍然不完整, 说明新数据已经全部拼接进来
+			std::memmove(m_pending, m_pending + c, (k + extra - c) * sizeof(input_type));
+			m_pending_size = k + extra - c;
+			return m_size;
+		}
+		m_pending_size = 0;
+		start = c - k;
+	}
+
+	reserve((n - start) * max_expansion);
+	auto c = convert(s + start, n - start);
+	if (!m_stopped)
+	{
+		// 末尾不完整的字符最多是一个字符的编码单元数减一
+		m_pending_size = n - start - c;
+		std::memcpy(m_pending, s + start + c, m_pending_size * sizeof(input_type));
+	}
+	return m_size;
+}
+
+template <extios::charset from, extios::charset to>
+inline std::size_t extios::transcoder<from, to>::feed(const std::basic_string<input_type> &text)
+{
+	return feed(text.c_str(), text.size());
+}
+
+template <extios::charset from, extios::charset to>
+inline std::size_t extios::transcoder<from, to>::finish(void)
+{
+	m_size = 0;
+	if (m_pending_size == 0 || m_stopped)
+	{
+		m_pending_size = 0;
+		return 0;
+	}
+
+	// 保存的字符不会再有后续数据, 一定是无效的字符
+	if (m_error_position == no_error)
+	{
+		m_error_position = m_consumed;
+	}
+	auto k = m_pending_size;
+	m_pending_size = 0;
+	reserve(k * max_expansion);
+	auto result = extios::convert_into(m_cvtor, m_pending, k, m_buffer, m_capacity);
+	m_size = result.written;
+	m_consumed += result.consumed;
+	// 与 feed 遇到无效字符时一样进入停止状态, 直到调用 reset()
+	m_stopped = m_cvtor.policy() == error_policy::stop;
+	return m_size;
+}
+
+template <extios::charset from, extios::charset to>
+inline void extios::transcoder<from, to>::reset(void) noexcept
+{
+	m_size = 0;
+	m_pending_size = 0;
+	m_consumed = 0;
+	m_error_position = no_error;
+	m_stopped = false;
+}
+
+template <extios::charset from, extios::charset to>
+inline auto extios::transcoder<from, to>::data(void) const noexcept -> const output_type *
+{
+	return m_buffer;
+}
+
+template <extios::charset from, extios::charset to>
+inline std::size_t extios::transcoder<from, to>::size(void) const noexcept
+{
+	return m_size;
+}
+
+template <extios::charset from, extios::charset to>
+inline std::uint64_t extios::transcoder<from, to>::consumed(void) const noexcept
+{
+	return m_consumed;
+}
+
+template <extios::charset from, extios::charset to>
+inline std::uint64_t extios::transcoder<from, to>::error_position(void) const noexcept
+{
+	return m_error_position;
+}
+
+template <extios::charset from, extios::charset to>
+inline bool extios::transcoder<from, to>::stopped(void) const noexcept
+{
+	return m_stopped;
+}
+
+template <extios::charset from, extios::charset to>
+inline const extios::codecvtor<from, to> & extios::transcoder<from, to>::convertor(void) const noexcept
+{
+	return m_cvtor;
+}
+
+template <extios::charset from, extios::charset to>
+inline std::size_t extios::transcoder<from, to>::convert(const input_type *s, std::size_t n)
+{
+	std::size_t done = 0;
+	for (;;)
+	{
+		auto result = extios::try_convert_into(m_cvtor, s + done, n - done, m_buffer + m_size, m_capacity - m_size);
+		// 末尾不完整的字符会留到下次转换, 不算作无效的字符
+		auto incomplete = result.status == convert_status::incomplete_input && result.error_position == result.consumed;
+		if (result.error_position != try_convert_result::no_error && !incomplete && m_error_position == no_error)
+		{
+			m_error_position = m_consumed + done + result.error_position;
+		}
+		m_size += result.written;
+		done += result.consumed;
+
+		switch (result.status)
+		{
+		case convert_status::insufficient_output:
+			reserve((n - done) * max_expansion);
+			continue;
+		case convert_status::invalid_input:
+			m_consumed += done;
+			if (m_cvtor.policy() == error_policy::throw_exception)
+			{
+				throw std::invalid_argument("需要转换编码的字符串不是有效的字符串");
+			}
+			m_stopped = true;
+			return done;
+		default:
+			m_consumed += done;
+			return done;
+		}
+	}
+}
+
+template <extios::charset from, extios::charset to>
+inline void extios::transcoder<from, to>::reserve(std::size_t n)
+{
+	if (m_capacity - m_size >= n)
+	{
+		return;
+	}
+
+	auto capacity = std::max(m_capacity * 2, m_size + n);
+	auto buffer = new output_type[capacity];
+	std::memcpy(buffer, m_buffer, m_size * sizeof(output_type));
+	release_buffer();
+	m_buffer = buffer;
+	m_capacity = capacity;
+}
+
+template <extios::charset from, extios::charset to>
+inline void extios::transcoder<from, to>::release_buffer(void) noexcept
+{
+	delete[] m_buffer;
+	m_buffer = nullptr;
+	m_capacity = 0;
+}
+
+#endif // !__EXTIOS_TRANSCODER_HPP__
@@ -0,0 +1,588 @@
+﻿#include <extios/extcodecvt.h>
+#include <extios/transcoder.hpp>
+#include <cstdio> // std::FILE std::fopen std::fread std::fwrite
+#include <cstring> // std::strcmp std::memmove
+#include <cctype> // std::tolower
+#include <cstdlib> // std::strtoul
+#include <string> // std::string
+#include <vector> // std::vector
+#include <stdexcept> // std::invalid_argument
+#include <system_error> // std::system_error
+#include <cerrno> // errno
+#include <cstddef> // std::nullptr_t
+#include <type_traits> // std::conditional
+#ifdef _MSC_VER
+#include <io.h> // _setmode _fileno
+#include <fcntl.h> // _O_BINARY
+#endif // _MSC_VER
+
+// 从标准输入或者输入文件每次读取的字节数
+static constexpr std::size_t read_size = static_cast<std::size_t>(1) << 20;
+
+// 命令行参数
+struct options
+{
+	extios::charset from; // 输入的字符集
+	extios::charset to; // 输出的字符集
+	extios::error_policy policy; // 遇到无效字符时的处理方式
+	unsigned int threads; // 最多使用的线程数
+	const char *output; // 输出文件路径, 为nullptr时输出到标准输出
+	bool help; // 只显示使用方法
+	std::vector<const char *> inputs; // 输入文件路径, 为空或者是"-"时从标准输入读取
+};
+
+
+// 输出使用方法
+// out 输出位置
+static void usage(std::FILE *out)
+{
+	std::fputs(
+		"用法: extios-convert -f 字符集 -t 字符集 [-p 处理方式] [-c] [-j 线程数] [-o 输出文件] [输入文件...]\n"
+		"\n"
+		"  -f 字符集      输入的字符集\n"
+		"  -t 字符集      输出的字符集\n"
+		"  -p 处理方式    遇到无效字符时的处理方式: throw(默认) replace question skip stop\n"
+		"  -c             同 -p skip\n"
+		"  -j 线程数      Unicode编码之间转换文件时最多使用的线程数, 0代表硬件支持的并发线程数, 默认是1\n"
+		"  -o 输出文件    输出到文件, 省略时输出到标准输出\n"
+		"  -h             显示本说明\n"
+		"\n"
+		"字符集: multibyte(本地字符集) widechar utf-8 utf-16 utf-32, UTF-16/UTF-32/宽字符使用本机字节序, 不处理BOM\n"
+		"只有一个输入文件并且指定了输出文件时, 输入文件映射到内存后转换, 否则分块读取后流式转换\n"
+		"没有输入文件或者输入文件是\"-\"时从标准输入读取\n"
+		"处理方式是stop时遇到无效字符后结束全部转换, 之后的输入文件不再转换\n",
+		out);
+}
+
+
+// 解析字符集的名称, 不区分大小写, 忽略'-'和'_'
+// name 字符集的名称
+// cs 解析结果
+// 返回值: 成功返回true
+static bool parse_charset(const char *name, extios::charset &cs)
+{
+	std::string key;
+	for (; *name != '\0'; ++name)
+	{
+		if (*name != '-' && *name != '_')
+		{
+			key += static_cast<char>(std::tolower(static_cast<unsigned char>(*name)));
+		}
+	}
+
+	if (key == "multibyte" || key == "locale" || key == "ansi")
+	{
+		cs = extios::charset::multibyte;
+	}
+	else if (key == "widechar" || key == "wchar" || key == "wchart")
+	{
+		cs = extios::charset::widechar;
+	}
+	else if (key == "utf8")
+	{
+		cs = extios::charset::utf8;
+	}
+	else if (key == "utf16")
+	{
+		cs = extios::charset::utf16;
+	}
+	else if (key == "utf32")
+	{
+		cs = extios::charset::utf32;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+
+// 解析遇到无效字符时的处理方式
+// name 处理方式的名称
+// policy 解析结果
+// 返回值: 成功返回true
+static bool parse_policy(const char *name, extios::error_policy &policy)
+{
+	if (std::strcmp(name, "throw") == 0)
+	{
+		policy = extios::error_policy::throw_exception;
+	}
+	else if (std::strcmp(name, "replace") == 0)
+	{
+		policy = extios::error_policy::replace;
+	}
+	else if (std::strcmp(name, "question") == 0)
+	{
+		policy = extios::error_policy::replace_with_question_mark;
+	}
+	else if (std::strcmp(name, "skip") == 0)
+	{
+		policy = extios::error_policy::skip;
+	}
+	else if (std::strcmp(name, "stop") == 0)
+	{
+		policy = extios::error_policy::stop;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+
+// 解析命令行参数
+// argc 参数个数
+// argv 参数
+// opts 解析结果
+// 返回值: 成功返回true
+static bool parse_options(int argc, char *argv[], options &opts)
+{
+	bool has_from = false;
+	bool has_to = false;
+	opts.policy = extios::error_policy::throw_exception;
+	opts.threads = 1;
+	opts.output = nullptr;
+	opts.help = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char *arg = argv[i];
+		if (arg[0] != '-' || arg[1] == '\0')
+		{
+			opts.inputs.push_back(arg);
+			continue;
+		}
+		if (std::strcmp(arg, "-c") == 0)
+		{
+			opts.policy = extios::error_policy::skip;
+			continue;
+		}
+		if (std::strcmp(arg, "-h") == 0)
+		{
+			opts.help = true;
+			return true;
+		}
+
+		// 其余选项都需要一个值
+		if (arg[2] != '\0' || i + 1 == argc)
+		{
+			return false;
+		}
+		const char *value = argv[++i];
+		switch (arg[1])
+		{
+		case 'f':
+			has_from = ::parse_charset(value, opts.from);
+			if (!has_from)
+			{
+				return false;
+			}
+			break;
+		case 't':
+			has_to = ::parse_charset(value, opts.to);
+			if (!has_to)
+			{
+				return false;
+			}
+			break;
+		case 'p':
+			if (!::parse_policy(value, opts.policy))
+			{
+				return false;
+			}
+			break;
+		case 'j':
+			opts.threads = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+			break;
+		case 'o':
+			opts.output = value;
+			break;
+		default:
+			return false;
+		}
+	}
+	return has_from && has_to;
+}
+
+
+// 完整写入n个字节
+// out 输出位置
+// s 需要写入的数据
+// n 字节数
+static void write_all(std::FILE *out, const void *s, std::size_t n)
+{
+	if (n != 0 && std::fwrite(s, 1, n, out) != n)
+	{
+		throw std::system_error(errno, std::generic_category(), "写入输出失败");
+	}
+}
+
+
+// 读取全部输入
+// in 输入位置
+// 返回值: 读取的数据
+static std::vector<char> read_all(std::FILE *in)
+{
+	std::vector<char> data;
+	std::size_t size = 0;
+	for (;;)
+	{
+		data.resize(size + ::read_size);
+		auto length = std::fread(data.data() + size, 1, ::read_size, in);
+		size += length;
+		if (length < ::read_size)
+		{
+			break;
+		}
+	}
+	if (std::ferror(in))
+	{
+		throw std::system_error(errno, std::generic_category(), "读取输入失败");
+	}
+	data.resize(size);
+	return data;
+}
+
+
+// 按照输出的字符集转换字符串
+// to 输出的字符集
+// cvtor 转换类对象
+// s 需要转换的字符串
+// n 需要转换的字符串的字符数
+template <extios::charset to, typename Convertor, typename charT>
+static auto convert_text(const Convertor &cvtor, const charT *s, std::size_t n)
+{
+	if constexpr (to == extios::charset::multibyte)
+	{
+		return extios::to_multibyte(cvtor, s, n);
+	}
+	else if constexpr (to == extios::charset::widechar)
+	{
+		return extios::to_widechar(cvtor, s, n);
+	}
+	else if constexpr (to == extios::charset::utf8)
+	{
+		return extios::to_utf8(cvtor, s, n);
+	}
+	else if constexpr (to == extios::charset::utf16)
+	{
+		return extios::to_utf16(cvtor, s, n);
+	}
+	else
+	{
+		return extios::to_utf32(cvtor, s, n);
+	}
+}
+
+
+// 按照处理方式输出输入末尾不足一个字符的字节, 和其他无效字符一样替换、丢弃或者停止
+// to 输出的字符集
+// out 输出位置
+// policy 遇到无效字符时的处理方式
+// 返回值: policy是stop时返回true
+template <extios::charset to>
+static bool write_truncated(std::FILE *out, extios::error_policy policy)
+{
+	if (policy == extios::error_policy::throw_exception)
+	{
+		throw std::invalid_argument("需要转换编码的字符串不是有效的字符串");
+	}
+	if (policy == extios::error_policy::replace || policy == extios::error_policy::replace_with_question_mark)
+	{
+		char32_t cp = policy == extios::error_policy::replace ? 0xFFFD : '?';
+		if constexpr (to == extios::charset::utf32)
+		{
+			::write_all(out, &cp, sizeof(cp));
+		}
+		else
+		{
+			extios::codecvtor<extios::charset::utf32, to> cvtor(policy);
+			auto text = ::convert_text<to>(cvtor, &cp, 1);
+			::write_all(out, text.data(), text.size() * sizeof(text[0]));
+		}
+	}
+	return policy == extios::error_policy::stop;
+}
+
+
+// 流式转换一个输入
+// from 输入的字符集
+// to 输出的字符集
+// in 输入位置
+// out 输出位置
+// policy 遇到无效字符时的处理方式
+// 返回值: policy是stop并且遇到无效字符时返回true, 之后的输入不再转换
+template <extios::charset from, extios::charset to>
+static bool convert_stream(std::FILE *in, std::FILE *out, extios::error_policy policy)
+{
+	if constexpr (from == extios::charset::multibyte && to == extios::charset::multibyte)
+	{
+		// 本地字符集之间直接复制
+		static_cast<void>(policy);
+		std::vector<char> buffer(::read_size);
+		for (;;)
+		{
+			auto length = std::fread(buffer.data(), 1, buffer.size(), in);
+			::write_all(out, buffer.data(), length);
+			if (length < buffer.size())
+			{
+				break;
+			}
+		}
+		if (std::ferror(in))
+		{
+			throw std::system_error(errno, std::generic_category(), "读取输入失败");
+		}
+		return false;
+	}
+	else if constexpr (from == extios::charset::multibyte || to == extios::charset::multibyte)
+	{
+		// 本地字符集不能在任意位置分段, 读取全部输入后整体转换
+		using InputCharType = typename extios::_hidden::charset_char<from>::type;
+		auto data = ::read_all(in);
+		bool truncated = data.size() % sizeof(InputCharType) != 0;
+		if (truncated && policy == extios::error_policy::throw_exception)
+		{
+			throw std::invalid_argument("需要转换编码的字符串不是有效的字符串");
+		}
+		auto s = reinterpret_cast<const InputCharType *>(data.data());
+		auto n = data.size() / sizeof(InputCharType);
+
+		// 转换函数不报告是否停止, stop时先按throw_exception转换, 遇到无效字符再按stop转换
+		auto policy_used = policy == extios::error_policy::stop ? extios::error_policy::throw_exception : policy;
+		bool stopped = false;
+		auto text = [&]
+		{
+			try
+			{
+				return ::convert_text<to>(extios::codecvtor<from, to>(policy_used), s, n);
+			}
+			catch (const std::invalid_argument &)
+			{
+				if (policy != extios::error_policy::stop)
+				{
+					throw;
+				}
+			}
+			stopped = true;
+			return ::convert_text<to>(extios::codecvtor<from, to>(policy), s, n);
+		}();
+		::write_all(out, text.data(), text.size() * sizeof(text[0]));
+		return stopped || (truncated && ::write_truncated<to>(out, policy));
+	}
+	else
+	{
+		// Unicode编码之间分块读取, 被分块截断的字符由transcoder保存到下一块
+		// 相同的编码也需要按照处理方式处理无效字符, 先转换到另一种Unicode编码, 再转换回来
+		constexpr auto middle = from != to ? to : from == extios::charset::utf32 ? extios::charset::utf16 : extios::charset::utf32;
+		using transcoder_type = extios::transcoder<from, middle>;
+		using InputCharType = typename transcoder_type::input_type;
+		using OutputCharType = typename transcoder_type::output_type;
+
+		transcoder_type cvt(policy, ::read_size);
+		typename std::conditional<from == to, extios::codecvtor<middle, to>, std::nullptr_t>::type back{};
+		auto write_output = [&](std::size_t n)
+		{
+			if constexpr (from == to)
+			{
+				auto text = ::convert_text<to>(back, cvt.data(), n);
+				::write_all(out, text.data(), text.size() * sizeof(text[0]));
+			}
+			else
+			{
+				::write_all(out, cvt.data(), n * sizeof(OutputCharType));
+			}
+		};
+
+		std::vector<char> buffer(::read_size + sizeof(InputCharType));
+		std::size_t carry = 0;
+		for (;;)
+		{
+			auto length = std::fread(buffer.data() + carry, 1, ::read_size, in);
+			auto size = carry + length;
+			write_output(cvt.feed(reinterpret_cast<const InputCharType *>(buffer.data()), size / sizeof(InputCharType)));
+			if (cvt.stopped())
+			{
+				return true;
+			}
+
+			// 不足一个字符的字节留到下次读取之后
+			carry = size % sizeof(InputCharType);
+			std::memmove(buffer.data(), buffer.data() + size - carry, carry);
+			if (length < ::read_size)
+			{
+				break;
+			}
+		}
+		if (std::ferror(in))
+		{
+			throw std::system_error(errno, std::generic_category(), "读取输入失败");
+		}
+		write_output(cvt.finish());
+		return cvt.stopped() || (carry != 0 && ::write_truncated<to>(out, policy));
+	}
+}
+
+
+// 按照输出的字符集选择流式转换函数
+// from 输入的字符集
+// to 输出的字符集
+// in 输入位置
+// out 输出位置
+// policy 遇到无效字符时的处理方式
+// 返回值: policy是stop并且遇到无效字符时返回true
+template <extios::charset from>
+static bool convert_stream(extios::charset to, std::FILE *in, std::FILE *out, extios::error_policy policy)
+{
+	switch (to)
+	{
+	case extios::charset::multibyte:
+		return ::convert_stream<from, extios::charset::multibyte>(in, out, policy);
+	case extios::charset::widechar:
+		return ::convert_stream<from, extios::charset::widechar>(in, out, policy);
+	case extios::charset::utf8:
+		return ::convert_stream<from, extios::charset::utf8>(in, out, policy);
+	case extios::charset::utf16:
+		return ::convert_stream<from, extios::charset::utf16>(in, out, policy);
+	default:
+		return ::convert_stream<from, extios::charset::utf32>(in, out, policy);
+	}
+}
+
+
+// 按照输入的字符集选择流式转换函数
+// opts 命令行参数
+// in 输入位置
+// out 输出位置
+// 返回值: policy是stop并且遇到无效字符时返回true
+static bool convert_stream(const options &opts, std::FILE *in, std::FILE *out)
+{
+	switch (opts.from)
+	{
+	case extios::charset::multibyte:
+		return ::convert_stream<extios::charset::multibyte>(opts.to, in, out, opts.policy);
+	case extios::charset::widechar:
+		return ::convert_stream<extios::charset::widechar>(opts.to, in, out, opts.policy);
+	case extios::charset::utf8:
+		return ::convert_stream<extios::charset::utf8>(opts.to, in, out, opts.policy);
+	case extios::charset::utf16:
+		return ::convert_stream<extios::charset::utf16>(opts.to, in, out, opts.policy);
+	default:
+		return ::convert_stream<extios::charset::utf32>(opts.to, in, out, opts.policy);
+	}
+}
+
+
+// 按照命令行参数转换全部输入
+// opts 命令行参数
+static void run(const options &opts)
+{
+	// 一个输入文件转换到输出文件时映射输入文件
+	if (opts.output != nullptr && opts.inputs.size() == 1 && std::strcmp(opts.inputs[0], "-") != 0)
+	{
+		extios::transcode_file(opts.inputs[0], opts.from, opts.output, opts.to, opts.policy, opts.threads);
+		return;
+	}
+
+	std::FILE *out = stdout;
+	if (opts.output != nullptr)
+	{
+		out = std::fopen(opts.output, "wb");
+		if (out == nullptr)
+		{
+			throw std::system_error(errno, std::generic_category(), "打开输出文件失败");
+		}
+	}
+
+	try
+	{
+		auto inputs = opts.inputs;
+		if (inputs.empty())
+		{
+			inputs.push_back("-");
+		}
+		// stop遇到无效字符时结束全部转换, 不再转换之后的输入
+		for (auto path : inputs)
+		{
+			bool stopped;
+			if (std::strcmp(path, "-") == 0)
+			{
+				stopped = ::convert_stream(opts, stdin, out);
+			}
+			else
+			{
+				auto in = std::fopen(path, "rb");
+				if (in == nullptr)
+				{
+					throw std::system_error(errno, std::generic_category(), std::string("打开输入文件失败: ") + path);
+				}
+				try
+				{
+					stopped = ::convert_stream(opts, in, out);
+				}
+				catch (...)
+				{
+					std::fclose(in);
+					throw;
+				}
+				std::fclose(in);
+			}
+			if (stopped)
+			{
+				break;
+			}
+		}
+	}
+	catch (...)
+	{
+		if (out != stdout)
+		{
+			std::fclose(out);
+		}
+		throw;
+	}
+
+	if (out != stdout ? std::fclose(out) != 0 : std::fflush(out) != 0)
+	{
+		throw std::system_error(errno, std::generic_category(), "写入输出失败");
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	options opts;
+	if (!::parse_options(argc, argv, opts))
+	{
+		::usage(stderr);
+		return 2;
+	}
+	if (opts.help)
+	{
+		::usage(stdout);
+		return 0;
+	}
+
+#ifdef _MSC_VER
+	_setmode(_fileno(stdin), _O_BINARY);
+	_setmode(_fileno(stdout), _O_BINARY);
+#endif // _MSC_VER
+
+	try
+	{
+		::run(opts);
+	}
+	catch (const std::invalid_argument &e)
+	{
+		std::fprintf(stderr, "extios-convert: %s\n", e.what());
+		return 1;
+	}
+	catch (const std::system_error &e)
+	{
+		std::fprintf(stderr, "extios-convert: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}